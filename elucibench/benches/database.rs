@@ -0,0 +1,211 @@
+//! Parameterized benches over every `Database` trait method, run against
+//! both backends. Parameters cover datum count, blob size, query
+//! selectivity, and designation count; see the crate docs for the
+//! baseline-comparison workflow.
+
+use criterion::{criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion, Throughput};
+use elucibench::{
+    build_database, designation_names, generate_data, query_box, spec_text, TempFile, SEED,
+};
+use elucidator_db::{
+    backends::{rtree::RTreeDatabase, sqlite::SqlDatabase},
+    database::Database,
+};
+use rand::{rngs::StdRng, SeedableRng};
+
+const DATUM_COUNTS: [usize; 2] = [1_000, 10_000];
+const BLOB_SIZES: [usize; 2] = [16, 1024];
+const SELECTIVITIES: [f64; 2] = [0.01, 0.25];
+const DESIGNATION_COUNTS: [usize; 2] = [1, 8];
+
+/// Datum count for benches not parameterized over it.
+const DEFAULT_COUNT: usize = 10_000;
+/// Blob size for benches not parameterized over it.
+const DEFAULT_BLOB: usize = 64;
+
+fn bench_insert_spec_text<D: Database>(c: &mut Criterion, backend: &str) {
+    let mut group = c.benchmark_group(format!("{backend}/insert_spec_text"));
+    for count in DESIGNATION_COUNTS {
+        let designations = designation_names(count);
+        let spec = spec_text(DEFAULT_BLOB);
+        group.bench_with_input(
+            BenchmarkId::new("designations", count),
+            &designations,
+            |b, designations| {
+                b.iter_batched(
+                    || D::new(None, None).unwrap(),
+                    |mut db| {
+                        for designation in designations {
+                            db.insert_spec_text(designation, &spec).unwrap();
+                        }
+                        db
+                    },
+                    BatchSize::SmallInput,
+                )
+            },
+        );
+    }
+    group.finish();
+}
+
+fn bench_insert_metadata<D: Database>(c: &mut Criterion, backend: &str) {
+    let mut group = c.benchmark_group(format!("{backend}/insert_metadata"));
+    for blob_size in BLOB_SIZES {
+        let designations = designation_names(1);
+        let data = generate_data(1_000, blob_size, 1);
+        group.throughput(Throughput::Elements(data.len() as u64));
+        group.bench_with_input(BenchmarkId::new("blob", blob_size), &data, |b, data| {
+            b.iter_batched(
+                || build_database::<D>(&designations, blob_size, &[]),
+                |mut db| {
+                    for datum in data {
+                        db.insert_metadata(&datum.as_metadata(&designations)).unwrap();
+                    }
+                    db
+                },
+                BatchSize::LargeInput,
+            )
+        });
+    }
+    group.finish();
+}
+
+fn bench_insert_n_metadata<D: Database>(c: &mut Criterion, backend: &str) {
+    let mut group = c.benchmark_group(format!("{backend}/insert_n_metadata"));
+    for count in DATUM_COUNTS {
+        let designations = designation_names(1);
+        let data = generate_data(count, DEFAULT_BLOB, 1);
+        let views: Vec<_> = data.iter().map(|o| o.as_metadata(&designations)).collect();
+        group.throughput(Throughput::Elements(count as u64));
+        group.bench_with_input(BenchmarkId::new("count", count), &views, |b, views| {
+            b.iter_batched(
+                || build_database::<D>(&designations, DEFAULT_BLOB, &[]),
+                |mut db| {
+                    db.insert_n_metadata(views).unwrap();
+                    db
+                },
+                BatchSize::LargeInput,
+            )
+        });
+    }
+    group.finish();
+}
+
+fn bench_get_metadata_in_bb<D: Database>(c: &mut Criterion, backend: &str) {
+    let mut group = c.benchmark_group(format!("{backend}/get_metadata_in_bb"));
+    let designations = designation_names(1);
+    let data = generate_data(DEFAULT_COUNT, DEFAULT_BLOB, 1);
+    let db: D = build_database(&designations, DEFAULT_BLOB, &data);
+    for selectivity in SELECTIVITIES {
+        let mut rng = StdRng::seed_from_u64(SEED);
+        let boxes: Vec<[f64; 8]> = (0..16).map(|_| query_box(selectivity, &mut rng)).collect();
+        group.bench_with_input(
+            BenchmarkId::new("selectivity", selectivity),
+            &boxes,
+            |b, boxes| {
+                b.iter(|| {
+                    for bb in boxes {
+                        db.get_metadata_in_bb(
+                            bb[0], bb[1], bb[2], bb[3], bb[4], bb[5], bb[6], bb[7], "bench0",
+                            None,
+                        )
+                        .unwrap();
+                    }
+                })
+            },
+        );
+    }
+    group.finish();
+}
+
+fn bench_get_metadata_blobs_in_bb<D: Database>(c: &mut Criterion, backend: &str) {
+    let mut group = c.benchmark_group(format!("{backend}/get_metadata_blobs_in_bb"));
+    for designation_count in DESIGNATION_COUNTS {
+        let designations = designation_names(designation_count);
+        let data = generate_data(DEFAULT_COUNT, DEFAULT_BLOB, designation_count);
+        let db: D = build_database(&designations, DEFAULT_BLOB, &data);
+        let mut rng = StdRng::seed_from_u64(SEED);
+        let boxes: Vec<[f64; 8]> = (0..16).map(|_| query_box(0.01, &mut rng)).collect();
+        group.bench_with_input(
+            BenchmarkId::new("designations", designation_count),
+            &boxes,
+            |b, boxes| {
+                b.iter(|| {
+                    for bb in boxes {
+                        db.get_metadata_blobs_in_bb(
+                            bb[0], bb[1], bb[2], bb[3], bb[4], bb[5], bb[6], bb[7], "bench0",
+                            None,
+                        )
+                        .unwrap();
+                    }
+                })
+            },
+        );
+    }
+    group.finish();
+}
+
+fn bench_get_nearest_metadata<D: Database>(c: &mut Criterion, backend: &str) {
+    let mut group = c.benchmark_group(format!("{backend}/get_nearest_metadata"));
+    for count in DATUM_COUNTS {
+        let designations = designation_names(1);
+        let data = generate_data(count, DEFAULT_BLOB, 1);
+        let db: D = build_database(&designations, DEFAULT_BLOB, &data);
+        group.bench_with_input(BenchmarkId::new("count", count), &db, |b, db| {
+            b.iter(|| db.get_nearest_metadata(0.5, 0.5, 0.5, 0.5, "bench0", 10).unwrap())
+        });
+    }
+    group.finish();
+}
+
+fn bench_save_as<D: Database>(c: &mut Criterion, backend: &str) {
+    let mut group = c.benchmark_group(format!("{backend}/save_as"));
+    group.sample_size(10);
+    let designations = designation_names(1);
+    let data = generate_data(DEFAULT_COUNT, DEFAULT_BLOB, 1);
+    let db: D = build_database(&designations, DEFAULT_BLOB, &data);
+    group.bench_function("save_as", |b| {
+        b.iter_batched(
+            || TempFile::new("bench.db"),
+            |tempfile| {
+                db.save_as(&tempfile.filepath).unwrap();
+                tempfile
+            },
+            BatchSize::PerIteration,
+        )
+    });
+    group.finish();
+}
+
+fn bench_from_path<D: Database>(c: &mut Criterion, backend: &str) {
+    let mut group = c.benchmark_group(format!("{backend}/from_path"));
+    group.sample_size(10);
+    let designations = designation_names(1);
+    let data = generate_data(DEFAULT_COUNT, DEFAULT_BLOB, 1);
+    let db: D = build_database(&designations, DEFAULT_BLOB, &data);
+    let tempfile = TempFile::new("bench.db");
+    db.save_as(&tempfile.filepath).unwrap();
+    group.bench_function("from_path", |b| {
+        b.iter(|| D::from_path(&tempfile.filepath).unwrap())
+    });
+    group.finish();
+}
+
+fn bench_backend<D: Database>(c: &mut Criterion, backend: &str) {
+    bench_insert_spec_text::<D>(c, backend);
+    bench_insert_metadata::<D>(c, backend);
+    bench_insert_n_metadata::<D>(c, backend);
+    bench_get_metadata_in_bb::<D>(c, backend);
+    bench_get_metadata_blobs_in_bb::<D>(c, backend);
+    bench_get_nearest_metadata::<D>(c, backend);
+    bench_save_as::<D>(c, backend);
+    bench_from_path::<D>(c, backend);
+}
+
+fn database_benches(c: &mut Criterion) {
+    bench_backend::<RTreeDatabase>(c, "rtree");
+    bench_backend::<SqlDatabase>(c, "sqlite");
+}
+
+criterion_group!(benches, database_benches);
+criterion_main!(benches);
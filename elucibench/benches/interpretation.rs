@@ -0,0 +1,62 @@
+//! Benches for the elucidator core hot paths: spec parsing and blob
+//! interpretation, parameterized over member count and blob size.
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use elucibench::{spec_text, wide_spec_text};
+use elucidator::designation::DesignationSpecification;
+use rand::{rngs::StdRng, Rng, SeedableRng};
+
+const MEMBER_COUNTS: [usize; 3] = [1, 8, 32];
+const BLOB_SIZES: [usize; 2] = [16, 1024];
+
+fn bench_from_text(c: &mut Criterion) {
+    let mut group = c.benchmark_group("elucidator/from_text");
+    for count in MEMBER_COUNTS {
+        let text = wide_spec_text(count);
+        group.bench_with_input(BenchmarkId::new("members", count), &text, |b, text| {
+            b.iter(|| DesignationSpecification::from_text(text).unwrap())
+        });
+    }
+    group.finish();
+}
+
+fn bench_interpret_enum(c: &mut Criterion) {
+    let mut group = c.benchmark_group("elucidator/interpret_enum");
+    for count in MEMBER_COUNTS {
+        let spec = DesignationSpecification::from_text(&wide_spec_text(count)).unwrap();
+        let buffer = vec![0u8; count * std::mem::size_of::<f64>()];
+        group.bench_with_input(
+            BenchmarkId::new("members", count),
+            &buffer,
+            |b, buffer| b.iter(|| spec.interpret_enum(buffer).unwrap()),
+        );
+    }
+    group.finish();
+}
+
+fn bench_compiled_interpret_enum(c: &mut Criterion) {
+    let mut group = c.benchmark_group("elucidator/compiled_interpret_enum");
+    let mut rng = StdRng::seed_from_u64(elucibench::SEED);
+    for blob_size in BLOB_SIZES {
+        let compiled = DesignationSpecification::from_text(&spec_text(blob_size))
+            .unwrap()
+            .compile();
+        let mut buffer = vec![0u8; blob_size];
+        rng.fill(buffer.as_mut_slice());
+        group.throughput(Throughput::Bytes(blob_size as u64));
+        group.bench_with_input(
+            BenchmarkId::new("blob", blob_size),
+            &buffer,
+            |b, buffer| b.iter(|| compiled.interpret_enum(buffer).unwrap()),
+        );
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_from_text,
+    bench_interpret_enum,
+    bench_compiled_interpret_enum
+);
+criterion_main!(benches);
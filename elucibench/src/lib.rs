@@ -0,0 +1,144 @@
+//! Shared fixtures for the criterion benches. Every generator is seeded
+//! so parameter sets reproduce exactly, which keeps runs comparable
+//! against a saved baseline:
+//!
+//! ```text
+//! cargo bench -p elucibench -- --save-baseline before
+//! # ...make changes...
+//! cargo bench -p elucibench -- --baseline before
+//! ```
+
+use elucidator_db::database::{Database, Metadata};
+use rand::{rngs::StdRng, Rng, SeedableRng};
+
+/// Seed for every fixture generator.
+pub const SEED: u64 = 1889;
+
+/// Side length of each datum's bounding box along every axis.
+const DATUM_SIDE: f64 = 0.01;
+
+/// One datum with owned storage; benches borrow `Metadata` views from it.
+/// Bounds are ordered xmin, xmax, ymin, ymax, zmin, zmax, tmin, tmax.
+#[derive(Debug, Clone)]
+pub struct OwnedDatum {
+    pub bounds: [f64; 8],
+    pub designation: usize,
+    pub buffer: Vec<u8>,
+}
+
+impl OwnedDatum {
+    pub fn as_metadata<'a>(&'a self, designations: &'a [String]) -> Metadata<'a> {
+        Metadata {
+            xmin: self.bounds[0],
+            xmax: self.bounds[1],
+            ymin: self.bounds[2],
+            ymax: self.bounds[3],
+            zmin: self.bounds[4],
+            zmax: self.bounds[5],
+            tmin: self.bounds[6],
+            tmax: self.bounds[7],
+            designation: &designations[self.designation],
+            buffer: &self.buffer,
+        }
+    }
+}
+
+pub fn designation_names(count: usize) -> Vec<String> {
+    (0..count).map(|i| format!("bench{i}")).collect()
+}
+
+/// Spec whose valid blobs are exactly `blob_size` raw bytes.
+pub fn spec_text(blob_size: usize) -> String {
+    format!("values: u8[{blob_size}]")
+}
+
+/// Spec with `member_count` f64 singletons, for the parse benches.
+pub fn wide_spec_text(member_count: usize) -> String {
+    (0..member_count)
+        .map(|i| format!("m{i}: f64"))
+        .collect::<Vec<String>>()
+        .join(", ")
+}
+
+/// Deterministic data set: small boxes uniform in the unit 4-cube,
+/// random blob bytes, designations assigned round-robin.
+pub fn generate_data(count: usize, blob_size: usize, designation_count: usize) -> Vec<OwnedDatum> {
+    let mut rng = StdRng::seed_from_u64(SEED);
+    (0..count)
+        .map(|i| {
+            let mut bounds = [0.0; 8];
+            for axis in 0..4 {
+                let lo = rng.gen::<f64>() * (1.0 - DATUM_SIDE);
+                bounds[2 * axis] = lo;
+                bounds[2 * axis + 1] = lo + DATUM_SIDE;
+            }
+            let mut buffer = vec![0u8; blob_size];
+            rng.fill(buffer.as_mut_slice());
+            OwnedDatum {
+                bounds,
+                designation: i % designation_count,
+                buffer,
+            }
+        })
+        .collect()
+}
+
+/// A query box expected to contain roughly `selectivity` of the data:
+/// each axis spans `selectivity^(1/4)` of the unit interval, placed
+/// uniformly. Bounds are ordered as in `OwnedDatum`.
+pub fn query_box(selectivity: f64, rng: &mut StdRng) -> [f64; 8] {
+    let side = selectivity.powf(0.25);
+    let mut bounds = [0.0; 8];
+    for axis in 0..4 {
+        let lo = rng.gen::<f64>() * (1.0 - side);
+        bounds[2 * axis] = lo;
+        bounds[2 * axis + 1] = lo + side;
+    }
+    bounds
+}
+
+/// Build a database of either backend, register one spec per
+/// designation, and bulk insert the fixture data.
+pub fn build_database<D: Database>(
+    designations: &[String],
+    blob_size: usize,
+    data: &[OwnedDatum],
+) -> D {
+    let mut db = D::new(None, None).unwrap();
+    let spec = spec_text(blob_size);
+    for designation in designations {
+        db.insert_spec_text(designation, &spec).unwrap();
+    }
+    let views: Vec<Metadata> = data.iter().map(|o| o.as_metadata(designations)).collect();
+    db.insert_n_metadata(&views).unwrap();
+    db
+}
+
+/// Scratch file for the persistence benches, deleted on drop. Paths are
+/// unique per instance so iterations never collide.
+#[derive(Debug)]
+pub struct TempFile {
+    pub filepath: String,
+}
+
+impl TempFile {
+    pub fn new(suffix: &str) -> Self {
+        use std::sync::atomic::{AtomicUsize, Ordering};
+        static COUNTER: AtomicUsize = AtomicUsize::new(0);
+        let unique = COUNTER.fetch_add(1, Ordering::Relaxed);
+        let filepath = std::env::temp_dir()
+            .join(format!(
+                "elucibench-{}-{unique}-{suffix}",
+                std::process::id()
+            ))
+            .to_string_lossy()
+            .into_owned();
+        TempFile { filepath }
+    }
+}
+
+impl Drop for TempFile {
+    fn drop(&mut self) {
+        let _ = std::fs::remove_file(&self.filepath);
+    }
+}
@@ -0,0 +1,302 @@
+use crate::{
+    backends::rtree::{RTreeDatabase, TreeEntry},
+    database::{Database, Result},
+};
+use rstar::{Envelope, RTreeObject, AABB};
+
+use std::collections::HashMap;
+use std::sync::{Arc, Mutex, RwLock};
+
+/// How many entries a writer stages locally before publishing the batch.
+const DEFAULT_BATCH_SIZE: usize = 4096;
+
+/// Staged entry awaiting a merge; carries its designation since staged
+/// batches mix designations.
+#[derive(Debug, Clone)]
+struct StagedEntry {
+    designation: Arc<str>,
+    entry: TreeEntry,
+}
+
+/// Shared state between the ingestor, its writers, and queries.
+#[derive(Debug)]
+struct IngestShared {
+    db: RwLock<RTreeDatabase>,
+    /// Published-but-unmerged batches. The lock is held only to push or
+    /// swap whole batches, never per entry.
+    staged: Mutex<Vec<Vec<StagedEntry>>>,
+}
+
+/// Concurrent ingest engine around an `RTreeDatabase`. Each producer
+/// thread gets its own `IngestWriter` and appends into a thread-local
+/// staging buffer with no shared lock; full buffers are published whole
+/// into a staging queue, and `merge_staged` folds the queue into the
+/// shared tree via bulk loading. Queries observe the union of the tree
+/// and everything staged, so merging is purely a performance operation.
+#[derive(Debug, Clone)]
+pub struct ConcurrentIngestor {
+    shared: Arc<IngestShared>,
+}
+
+impl ConcurrentIngestor {
+    pub fn new(db: RTreeDatabase) -> Self {
+        ConcurrentIngestor {
+            shared: Arc::new(IngestShared {
+                db: RwLock::new(db),
+                staged: Mutex::new(Vec::new()),
+            }),
+        }
+    }
+    /// Create a writer for one producer thread.
+    pub fn writer(&self) -> IngestWriter {
+        IngestWriter {
+            shared: Arc::clone(&self.shared),
+            local: Vec::new(),
+            batch_size: DEFAULT_BATCH_SIZE,
+        }
+    }
+    /// Register a spec, as `Database::insert_spec_text` would.
+    pub fn insert_spec_text(&self, designation: &str, spec: &str) -> Result<()> {
+        self.shared.db.write()?.insert_spec_text(designation, spec)
+    }
+    /// Fold all published batches into the tree. Batches are grouped by
+    /// designation and handed to bulk insertion, so the cost per merge is
+    /// proportional to the staged volume. Returns how many entries merged.
+    ///
+    /// The tree lock is taken before the staging queue is drained, and
+    /// queries scan the queue while holding the tree lock, so a query
+    /// never observes entries gone from the queue but not yet in the
+    /// tree.
+    pub fn merge_staged(&self) -> Result<usize> {
+        let mut db = self.shared.db.write()?;
+        let batches = std::mem::take(&mut *self.shared.staged.lock()?);
+        if batches.is_empty() {
+            return Ok(0);
+        }
+        let mut groups: HashMap<Arc<str>, Vec<TreeEntry>> = HashMap::new();
+        let mut merged = 0;
+        for batch in batches {
+            merged += batch.len();
+            for staged in batch {
+                groups.entry(staged.designation).or_default().push(staged.entry);
+            }
+        }
+        for (designation, entries) in groups {
+            let id = db.intern_designation(&designation);
+            db.bulk_insert(id, entries);
+        }
+        Ok(merged)
+    }
+    /// Entries in the tree plus entries staged for merge.
+    pub fn size(&self) -> Result<usize> {
+        let staged: usize = self.shared.staged.lock()?.iter().map(Vec::len).sum();
+        Ok(self.shared.db.read()?.size() + staged)
+    }
+    /// Bounding-box query over the union of the merged tree and every
+    /// published staging buffer. Buffers are cloned out so no lock is
+    /// held by the result.
+    #[allow(clippy::too_many_arguments)]
+    pub fn get_metadata_blobs_in_bb(
+        &self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        epsilon: Option<f64>,
+    ) -> Result<Vec<Vec<u8>>> {
+        // Hold the tree lock across the staged scan so a concurrent merge
+        // cannot drain the queue between the two halves of the union.
+        let db = self.shared.db.read()?;
+        let mut blobs: Vec<Vec<u8>> = db.get_metadata_blobs_in_bb(
+            xmin,
+            xmax,
+            ymin,
+            ymax,
+            zmin,
+            zmax,
+            tmin,
+            tmax,
+            designation,
+            epsilon,
+        )?;
+        let eps = epsilon.unwrap_or(0.0);
+        let bb = AABB::from_corners(
+            [xmin - eps, ymin - eps, zmin - eps, tmin - eps],
+            [xmax + eps, ymax + eps, zmax + eps, tmax + eps],
+        );
+        for batch in self.shared.staged.lock()?.iter() {
+            for staged in batch {
+                if staged.designation.as_ref() == designation
+                    && bb.contains_envelope(&staged.entry.envelope())
+                {
+                    blobs.push(staged.entry.buffer.clone());
+                }
+            }
+        }
+        Ok(blobs)
+    }
+    /// Merge anything still staged and recover the database. Fails if
+    /// writers are still holding the ingestor.
+    pub fn into_inner(self) -> Result<RTreeDatabase> {
+        self.merge_staged()?;
+        match Arc::try_unwrap(self.shared) {
+            Ok(shared) => Ok(shared.db.into_inner()?),
+            Err(_) => Err(crate::error::DatabaseError::LockError {
+                reason: "Cannot recover database while writers are live".to_string(),
+            }),
+        }
+    }
+}
+
+/// Per-producer staging buffer. Appends touch only thread-local memory;
+/// the shared queue is locked once per full batch, so insert throughput
+/// scales with producer cores.
+#[derive(Debug)]
+pub struct IngestWriter {
+    shared: Arc<IngestShared>,
+    local: Vec<StagedEntry>,
+    batch_size: usize,
+}
+
+impl IngestWriter {
+    /// Stage one metadatum, publishing the local buffer when it fills.
+    #[allow(clippy::too_many_arguments)]
+    pub fn insert_metadata_owned(
+        &mut self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        buffer: Vec<u8>,
+    ) -> Result<()> {
+        self.local.push(StagedEntry {
+            designation: designation.into(),
+            entry: TreeEntry {
+                xmin,
+                xmax,
+                ymin,
+                ymax,
+                zmin,
+                zmax,
+                tmin,
+                tmax,
+                buffer,
+            },
+        });
+        if self.local.len() >= self.batch_size {
+            self.publish()?;
+        }
+        Ok(())
+    }
+    /// Publish the local buffer so queries and merges can see it.
+    pub fn publish(&mut self) -> Result<()> {
+        if !self.local.is_empty() {
+            let batch = std::mem::take(&mut self.local);
+            self.shared.staged.lock()?.push(batch);
+        }
+        Ok(())
+    }
+}
+
+impl Drop for IngestWriter {
+    fn drop(&mut self) {
+        let _ = self.publish();
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    fn spec_db() -> RTreeDatabase {
+        let mut db = RTreeDatabase::new(None, None).unwrap();
+        db.insert_spec_text("Foo", "foo: u8").unwrap();
+        db
+    }
+
+    #[test]
+    fn staged_entries_visible_before_merge() {
+        let ingestor = ConcurrentIngestor::new(spec_db());
+        let mut writer = ingestor.writer();
+        writer
+            .insert_metadata_owned(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", vec![42])
+            .unwrap();
+        writer.publish().unwrap();
+
+        let blobs = ingestor
+            .get_metadata_blobs_in_bb(
+                -1.0,
+                2.0,
+                -1.0,
+                2.0,
+                -1.0,
+                2.0,
+                -1.0,
+                2.0,
+                "Foo",
+                None,
+            )
+            .unwrap();
+        pretty_assertions::assert_eq!(blobs, vec![vec![42]]);
+    }
+
+    #[test]
+    fn merge_moves_staged_into_tree() {
+        let ingestor = ConcurrentIngestor::new(spec_db());
+        let mut writer = ingestor.writer();
+        for i in 0..10u8 {
+            let lo = f64::from(i);
+            writer
+                .insert_metadata_owned(lo, lo + 0.5, lo, lo + 0.5, 0.0, 1.0, 0.0, 1.0, "Foo", vec![i])
+                .unwrap();
+        }
+        drop(writer);
+
+        assert_eq!(ingestor.merge_staged().unwrap(), 10);
+        assert_eq!(ingestor.merge_staged().unwrap(), 0);
+        let db = ingestor.into_inner().unwrap();
+        assert_eq!(db.size(), 10);
+    }
+
+    #[test]
+    fn parallel_writers_ingest_all() {
+        let ingestor = ConcurrentIngestor::new(spec_db());
+        std::thread::scope(|scope| {
+            for t in 0..4u8 {
+                let mut writer = ingestor.writer();
+                scope.spawn(move || {
+                    for i in 0..100u8 {
+                        let lo = f64::from(i);
+                        writer
+                            .insert_metadata_owned(
+                                lo,
+                                lo + 0.5,
+                                lo,
+                                lo + 0.5,
+                                0.0,
+                                1.0,
+                                0.0,
+                                1.0,
+                                "Foo",
+                                vec![t, i],
+                            )
+                            .unwrap();
+                    }
+                });
+            }
+        });
+        ingestor.merge_staged().unwrap();
+        let db = ingestor.into_inner().unwrap();
+        assert_eq!(db.size(), 400);
+    }
+}
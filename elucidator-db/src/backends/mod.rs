@@ -1,2 +1,5 @@
+pub mod ingest;
 pub mod rtree;
+pub mod sharded;
 pub mod sqlite;
+pub mod write_behind;
@@ -1,17 +1,184 @@
 use crate::{
     backends::sqlite::SqlDatabase,
-    database::{Database, DatabaseConfig, Datum, Metadata, Result},
+    database::{BoundingBox, Database, DatabaseConfig, Datum, Metadata, Result},
+    error::DatabaseError,
 };
-use rstar::{RTree, RTreeObject, AABB};
+#[cfg(feature = "instrumentation")]
+use crate::instrumentation::{InstrumentationReport, Instruments, TreeShape};
+use memmap2::Mmap;
+use rayon::prelude::*;
+use rstar::{PointDistance, RTree, RTreeObject, AABB};
 
-use elucidator::designation::DesignationSpecification;
+use elucidator::designation::{CompiledInterpreter, DesignationSpecification};
+use elucidator::error::ElucidatorError;
+use elucidator::value::{ColumnarData, DataValue};
 use std::collections::HashMap;
+use std::fs::File;
+use std::io::{BufWriter, Read, Write};
+use std::sync::Arc;
+
+/// Eight-byte magic prefix identifying a native snapshot file.
+const SNAPSHOT_MAGIC: &[u8; 8] = b"ELUCSNAP";
+/// Current snapshot format version.
+const SNAPSHOT_VERSION: u32 = 2;
+/// Bytes per fixed-width entry record: eight bounds plus blob length and
+/// blob offset.
+const SNAPSHOT_RECORD_BYTES: usize = 8 * 8 + 8 + 8;
+/// Write-ahead log record holding an inserted spec.
+const WAL_SPEC_TAG: u8 = 1;
+/// Write-ahead log record holding an inserted metadatum.
+const WAL_METADATA_TAG: u8 = 2;
+/// Compact the log into the snapshot once this many records accumulate.
+const WAL_COMPACTION_THRESHOLD: usize = 100_000;
 
 #[derive(Debug)]
 pub struct RTreeDatabase {
-    /// R*-Tree used internally
-    rtree: RTree<MetadataClone>,
-    designations: HashMap<String, DesignationSpecification>,
+    /// One R*-Tree per designation, indexed by interned designation ID, so
+    /// queries only traverse the tree holding their designation. Trees
+    /// hold only envelopes plus blob indexes; blob bytes live in `blobs`.
+    trees: Vec<RTree<EnvelopeRef>>,
+    /// Dense per-designation blob arrays, parallel to `trees` and indexed
+    /// by each envelope's blob number
+    blobs: Vec<Vec<Vec<u8>>>,
+    designations: HashMap<String, Arc<DesignationSpecification>>,
+    /// Compiled interpreter for each designation's spec
+    interpreters: HashMap<String, CompiledInterpreter>,
+    /// Designation text to interned integer ID
+    designation_ids: HashMap<String, u32>,
+    /// Designation text for each interned ID, indexed by ID
+    designation_names: Vec<String>,
+    /// Incremental persistence, attached by `open_wal`
+    wal: Option<WriteAheadLog>,
+    /// Declared member indexes per designation, keyed by member name
+    member_indexes: HashMap<String, HashMap<String, MemberIndex>>,
+    /// Latency histograms and query counters, present only with the
+    /// `instrumentation` feature
+    #[cfg(feature = "instrumentation")]
+    instruments: Instruments,
+}
+
+/// Comparison applied by a [`MemberPredicate`].
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum PredicateOp {
+    Lt,
+    Le,
+    Gt,
+    Ge,
+    Eq,
+    Ne,
+}
+
+/// Filter on one decoded member value, compared numerically. Only
+/// numeric singleton members can be filtered.
+#[derive(Debug, Clone, PartialEq)]
+pub struct MemberPredicate {
+    pub member: String,
+    pub op: PredicateOp,
+    pub value: f64,
+}
+
+impl MemberPredicate {
+    pub fn new(member: &str, op: PredicateOp, value: f64) -> Self {
+        MemberPredicate {
+            member: member.to_string(),
+            op,
+            value,
+        }
+    }
+    fn matches(&self, v: f64) -> bool {
+        match self.op {
+            PredicateOp::Lt => v < self.value,
+            PredicateOp::Le => v <= self.value,
+            PredicateOp::Gt => v > self.value,
+            PredicateOp::Ge => v >= self.value,
+            PredicateOp::Eq => v == self.value,
+            PredicateOp::Ne => v != self.value,
+        }
+    }
+    /// Whether any value in `[min, max]` could match; powers index
+    /// pruning.
+    fn overlaps(&self, min: f64, max: f64) -> bool {
+        match self.op {
+            PredicateOp::Lt => min < self.value,
+            PredicateOp::Le => min <= self.value,
+            PredicateOp::Gt => max > self.value,
+            PredicateOp::Ge => max >= self.value,
+            PredicateOp::Eq => min <= self.value && self.value <= max,
+            PredicateOp::Ne => !(min == max && min == self.value),
+        }
+    }
+}
+
+/// Observed value range of one indexed member, widened on insert.
+#[derive(Debug, Clone, Copy)]
+struct MemberIndex {
+    min: f64,
+    max: f64,
+}
+
+/// Memory accounting for one designation's storage, reported by
+/// [`RTreeDatabase::memory_usage`].
+#[derive(Debug, Clone, PartialEq)]
+pub struct DesignationMemoryUsage {
+    pub designation: String,
+    /// Number of stored data
+    pub count: usize,
+    /// Bytes of envelope records held by the tree
+    pub envelope_bytes: usize,
+    /// Bytes of blob payload
+    pub blob_bytes: usize,
+    /// Container overhead: blob `Vec` headers and unused capacity
+    pub overhead_bytes: usize,
+}
+
+/// Numeric view of a singleton member value.
+fn datavalue_as_f64(value: &DataValue) -> Option<f64> {
+    match value {
+        DataValue::Byte(v) => Some(f64::from(*v)),
+        DataValue::UnsignedInteger16(v) => Some(f64::from(*v)),
+        DataValue::UnsignedInteger32(v) => Some(f64::from(*v)),
+        DataValue::UnsignedInteger64(v) => Some(*v as f64),
+        DataValue::SignedInteger8(v) => Some(f64::from(*v)),
+        DataValue::SignedInteger16(v) => Some(f64::from(*v)),
+        DataValue::SignedInteger32(v) => Some(f64::from(*v)),
+        DataValue::SignedInteger64(v) => Some(*v as f64),
+        DataValue::Float32(v) => Some(f64::from(*v)),
+        DataValue::Float64(v) => Some(*v),
+        _ => None,
+    }
+}
+
+/// Extract one member from a blob as `f64`, decoding only that member's
+/// bytes when the spec has a fixed layout.
+fn member_as_f64(
+    interpreter: &CompiledInterpreter,
+    member: &str,
+    buffer: &[u8],
+) -> Result<f64> {
+    let value = interpreter.extract_member(member, buffer)?;
+    datavalue_as_f64(&value).ok_or_else(|| DatabaseError::ConfigError {
+        reason: format!("Member \"{member}\" is not a numeric singleton"),
+    })
+}
+
+/// Append-only write-ahead log attached to an `RTreeDatabase`. Inserts
+/// are appended (buffered) as they happen, and the log is periodically
+/// compacted into the snapshot so checkpoint cost is proportional to new
+/// data rather than total data.
+#[derive(Debug)]
+pub struct WriteAheadLog {
+    /// Snapshot file the log compacts into
+    snapshot_path: String,
+    /// Log file, always `<snapshot_path>.log`
+    log_path: String,
+    writer: BufWriter<File>,
+    /// Generation stamped on appended records. The snapshot records the
+    /// generation it covers, so replay can skip records a compaction
+    /// already folded in even if truncating the log did not complete.
+    generation: u64,
+    /// Records appended since the log was last compacted
+    pending: usize,
+    compaction_threshold: usize,
 }
 
 pub struct RTreeConfig {
@@ -28,10 +195,111 @@ pub struct MetadataClone {
     pub zmax: f64,
     pub tmin: f64,
     pub tmax: f64,
-    pub designation: String,
+    pub designation: Arc<str>,
     pub buffer: Vec<u8>,
 }
 
+/// Element stored in the R*-Tree. The designation is implied by which
+/// per-designation tree holds the element, so entries carry only their
+/// envelope and buffer.
+#[derive(Debug, Clone, PartialEq)]
+pub struct TreeEntry {
+    pub xmin: f64,
+    pub xmax: f64,
+    pub ymin: f64,
+    pub ymax: f64,
+    pub zmin: f64,
+    pub zmax: f64,
+    pub tmin: f64,
+    pub tmax: f64,
+    pub buffer: Vec<u8>,
+}
+
+impl RTreeObject for &TreeEntry {
+    type Envelope = AABB<[f64; 4]>;
+
+    fn envelope(&self) -> Self::Envelope {
+        AABB::from_corners(
+            (self.xmin, self.ymin, self.zmin, self.tmin).into(),
+            (self.xmax, self.ymax, self.zmax, self.tmax).into(),
+        )
+    }
+}
+
+impl RTreeObject for TreeEntry {
+    type Envelope = AABB<[f64; 4]>;
+
+    fn envelope(&self) -> Self::Envelope {
+        AABB::from_corners(
+            (self.xmin, self.ymin, self.zmin, self.tmin).into(),
+            (self.xmax, self.ymax, self.zmax, self.tmax).into(),
+        )
+    }
+}
+
+impl PointDistance for TreeEntry {
+    fn distance_2(&self, point: &[f64; 4]) -> f64 {
+        self.envelope().distance_2(point)
+    }
+}
+
+/// Element actually stored in the R*-Tree: a dense envelope plus the
+/// index of its blob in the designation's parallel blob array. Keeping
+/// blob bytes and their `Vec` headers out of the nodes shrinks the
+/// traversal working set, and tree rebuilds shuffle these 72-byte
+/// records instead of moving blob allocations.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub(crate) struct EnvelopeRef {
+    mins: [f64; 4],
+    maxs: [f64; 4],
+    blob: u32,
+}
+
+impl RTreeObject for EnvelopeRef {
+    type Envelope = AABB<[f64; 4]>;
+
+    fn envelope(&self) -> Self::Envelope {
+        AABB::from_corners(self.mins, self.maxs)
+    }
+}
+
+impl PointDistance for EnvelopeRef {
+    fn distance_2(&self, point: &[f64; 4]) -> f64 {
+        self.envelope().distance_2(point)
+    }
+}
+
+/// Borrowed view of one stored datum: its envelope and a reference to
+/// its blob in the designation's dense blob array.
+#[derive(Debug, Clone, PartialEq)]
+pub struct MetadataRef<'a> {
+    pub xmin: f64,
+    pub xmax: f64,
+    pub ymin: f64,
+    pub ymax: f64,
+    pub zmin: f64,
+    pub zmax: f64,
+    pub tmin: f64,
+    pub tmax: f64,
+    pub buffer: &'a Vec<u8>,
+}
+
+impl<'a> MetadataRef<'a> {
+    fn new(blobs: &'a [Vec<u8>], r: &EnvelopeRef) -> Self {
+        MetadataRef {
+            xmin: r.mins[0],
+            xmax: r.maxs[0],
+            ymin: r.mins[1],
+            ymax: r.maxs[1],
+            zmin: r.mins[2],
+            zmax: r.maxs[2],
+            tmin: r.mins[3],
+            tmax: r.maxs[3],
+            buffer: &blobs[r.blob as usize],
+        }
+    }
+}
+
 impl From<Metadata<'_>> for MetadataClone {
     fn from(m: Metadata) -> Self {
         MetadataClone {
@@ -43,7 +311,7 @@ impl From<Metadata<'_>> for MetadataClone {
             zmax: m.zmax,
             tmin: m.tmin,
             tmax: m.tmax,
-            designation: m.designation.to_string(),
+            designation: m.designation.into(),
             buffer: m.buffer.into(),
         }
     }
@@ -60,12 +328,851 @@ impl From<&Metadata<'_>> for MetadataClone {
             zmax: m.zmax,
             tmin: m.tmin,
             tmax: m.tmax,
-            designation: m.designation.to_string(),
+            designation: m.designation.into(),
             buffer: m.buffer.into(),
         }
     }
 }
 
+impl RTreeDatabase {
+    /// Fetch the interned ID for a designation, assigning one and creating
+    /// its tree on first use.
+    pub(crate) fn intern_designation(&mut self, designation: &str) -> u32 {
+        if let Some(id) = self.designation_ids.get(designation) {
+            *id
+        } else {
+            let id = self.designation_names.len() as u32;
+            self.designation_names.push(designation.to_string());
+            self.designation_ids.insert(designation.to_string(), id);
+            self.trees.push(RTree::new());
+            self.blobs.push(Vec::new());
+            id
+        }
+    }
+    /// Create a builder for populating a new database in one shot.
+    pub fn builder() -> RTreeDatabaseBuilder {
+        RTreeDatabaseBuilder::new()
+    }
+    /// Total number of data across all designations.
+    pub fn size(&self) -> usize {
+        self.trees.iter().map(RTree::size).sum()
+    }
+    /// Insert a batch of entries for one designation, preferring rstar's
+    /// bulk loading. An empty tree is bulk loaded directly. When the batch
+    /// rivals the current tree in size, the tree is rebuilt by bulk loading
+    /// the union; otherwise the entries are inserted incrementally.
+    pub(crate) fn bulk_insert(&mut self, designation_id: u32, entries: Vec<TreeEntry>) {
+        let designation = &self.designation_names[designation_id as usize];
+        if self.member_indexes.contains_key(designation) {
+            let designation = designation.clone();
+            for entry in &entries {
+                self.note_indexed_insert(&designation, &entry.buffer);
+            }
+        }
+        let blob_store = &mut self.blobs[designation_id as usize];
+        let mut refs = Vec::with_capacity(entries.len());
+        for entry in entries {
+            let blob = blob_store.len() as u32;
+            refs.push(EnvelopeRef {
+                mins: [entry.xmin, entry.ymin, entry.zmin, entry.tmin],
+                maxs: [entry.xmax, entry.ymax, entry.zmax, entry.tmax],
+                blob,
+            });
+            blob_store.push(entry.buffer);
+        }
+        let tree = &mut self.trees[designation_id as usize];
+        if tree.size() == 0 {
+            *tree = RTree::bulk_load(refs);
+        } else if refs.len() >= tree.size() {
+            let existing = std::mem::replace(tree, RTree::new());
+            refs.extend(existing.into_iter());
+            *tree = RTree::bulk_load(refs);
+        } else {
+            for r in refs {
+                tree.insert(r);
+            }
+        }
+    }
+    /// Report memory consumption per designation: datum counts, envelope
+    /// record bytes in the tree, blob payload bytes, and container
+    /// overhead (blob `Vec` headers plus unused capacity). Intended for
+    /// capacity planning against live databases.
+    pub fn memory_usage(&self) -> Vec<DesignationMemoryUsage> {
+        self.designation_names
+            .iter()
+            .enumerate()
+            .map(|(id, name)| {
+                let blobs = &self.blobs[id];
+                let count = blobs.len();
+                let blob_bytes: usize = blobs.iter().map(Vec::len).sum();
+                let spare: usize = blobs.iter().map(|b| b.capacity() - b.len()).sum();
+                DesignationMemoryUsage {
+                    designation: name.clone(),
+                    count,
+                    envelope_bytes: count * std::mem::size_of::<EnvelopeRef>(),
+                    blob_bytes,
+                    overhead_bytes: spare
+                        + blobs.capacity() * std::mem::size_of::<Vec<u8>>(),
+                }
+            })
+            .collect()
+    }
+    /// Declare an index on one member of a designation. The index tracks
+    /// the member's observed value range: it is built from the data
+    /// already in the tree, widened on every insert, and consulted by
+    /// predicate queries to skip scans that cannot match. Indexes live in
+    /// memory and are redeclared per process.
+    pub fn declare_member_index(&mut self, designation: &str, member: &str) -> Result<()> {
+        let interpreter =
+            self.interpreters
+                .get(designation)
+                .ok_or_else(|| DatabaseError::ConfigError {
+                    reason: format!("No designation \"{designation}\" to index"),
+                })?;
+        if !interpreter.has_member(member) {
+            Err(DatabaseError::ConfigError {
+                reason: format!("Designation \"{designation}\" has no member \"{member}\""),
+            })?
+        }
+        let mut index = MemberIndex {
+            min: f64::INFINITY,
+            max: f64::NEG_INFINITY,
+        };
+        if let Some(id) = self.designation_ids.get(designation) {
+            for buffer in &self.blobs[*id as usize] {
+                let value = member_as_f64(interpreter, member, buffer)?;
+                index.min = index.min.min(value);
+                index.max = index.max.max(value);
+            }
+        }
+        self.member_indexes
+            .entry(designation.to_string())
+            .or_default()
+            .insert(member.to_string(), index);
+        Ok(())
+    }
+    /// Widen the designation's declared indexes for one inserted blob. A
+    /// blob whose member cannot be read disables pruning for that index
+    /// rather than risking a wrong skip.
+    fn note_indexed_insert(&mut self, designation: &str, buffer: &[u8]) {
+        let Self {
+            member_indexes,
+            interpreters,
+            ..
+        } = self;
+        let Some(indexes) = member_indexes.get_mut(designation) else {
+            return;
+        };
+        let interpreter = &interpreters[designation];
+        for (member, index) in indexes.iter_mut() {
+            match member_as_f64(interpreter, member, buffer) {
+                Ok(value) => {
+                    index.min = index.min.min(value);
+                    index.max = index.max.max(value);
+                }
+                Err(_) => {
+                    index.min = f64::NEG_INFINITY;
+                    index.max = f64::INFINITY;
+                }
+            }
+        }
+    }
+    /// Bounding-box query filtered by member predicates. Predicates must
+    /// name numeric singleton members of the designation's spec; anything
+    /// else is an error rather than an empty result, so typos fail
+    /// loudly. Each candidate's predicate members are decoded straight
+    /// from their fixed blob offsets, so only rows passing every
+    /// predicate are fully interpreted; when a declared index proves the
+    /// designation's value range cannot match, the scan is skipped
+    /// entirely.
+    #[allow(clippy::too_many_arguments)]
+    pub fn get_metadata_in_bb_where(
+        &self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        epsilon: Option<f64>,
+        predicates: &[MemberPredicate],
+    ) -> Result<Vec<Datum>> {
+        let interpreter = &self.interpreters[designation];
+        for predicate in predicates {
+            if !interpreter.has_member(&predicate.member) {
+                Err(DatabaseError::ConfigError {
+                    reason: format!(
+                        "Designation \"{designation}\" has no member \"{}\" to filter on",
+                        predicate.member
+                    ),
+                })?
+            }
+            if !interpreter.has_numeric_singleton_member(&predicate.member) {
+                Err(DatabaseError::ConfigError {
+                    reason: format!(
+                        "Member \"{}\" is not a numeric singleton",
+                        predicate.member
+                    ),
+                })?
+            }
+        }
+        if let Some(indexes) = self.member_indexes.get(designation) {
+            for predicate in predicates {
+                if let Some(index) = indexes.get(&predicate.member) {
+                    if index.min <= index.max && !predicate.overlaps(index.min, index.max) {
+                        return Ok(Vec::new());
+                    }
+                }
+            }
+        }
+        let blobs = self
+            .iter_metadata_blobs_in_bb(
+                xmin,
+                xmax,
+                ymin,
+                ymax,
+                zmin,
+                zmax,
+                tmin,
+                tmax,
+                designation,
+                epsilon,
+            )
+            .map(|m| m.buffer.as_slice())
+            .filter(|buffer| {
+                predicates.iter().all(|p| {
+                    member_as_f64(interpreter, &p.member, buffer)
+                        .map(|v| p.matches(v))
+                        .unwrap_or(false)
+                })
+            })
+            .collect::<Vec<&[u8]>>();
+        Ok(blobs
+            .par_iter()
+            .map(|b| interpreter.interpret_enum(b).unwrap())
+            .collect())
+    }
+    /// Run one bounding-box query per envelope, fanning the searches out
+    /// across rayon's thread pool against the shared immutable trees.
+    pub fn get_metadata_in_bbs(
+        &self,
+        boxes: &[BoundingBox],
+        designation: &str,
+        epsilon: Option<f64>,
+    ) -> Result<Vec<Vec<Datum>>> {
+        boxes
+            .par_iter()
+            .map(|b| {
+                self.get_metadata_in_bb(
+                    b.xmin,
+                    b.xmax,
+                    b.ymin,
+                    b.ymax,
+                    b.zmin,
+                    b.zmax,
+                    b.tmin,
+                    b.tmax,
+                    designation,
+                    epsilon,
+                )
+            })
+            .collect()
+    }
+    /// Lazily iterate over the entries matching a bounding box, straight
+    /// off the tree traversal. Unlike `get_metadata_blobs_in_bb`, no result
+    /// `Vec` is materialized, so consumers that stream over hits or exit
+    /// early pay O(1) memory. Each entry carries its envelope and blob; the
+    /// designation is the one queried.
+    #[allow(clippy::too_many_arguments)]
+    pub fn iter_metadata_blobs_in_bb(
+        &self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        epsilon: Option<f64>,
+    ) -> impl Iterator<Item = MetadataRef<'_>> {
+        let found = self.designation_ids.get(designation).map(|id| {
+            (
+                &self.trees[*id as usize],
+                self.blobs[*id as usize].as_slice(),
+            )
+        });
+        let eps = epsilon.unwrap_or(0.0);
+        let mins = [xmin - eps, ymin - eps, zmin - eps, tmin - eps];
+        let maxs = [xmax + eps, ymax + eps, zmax + eps, tmax + eps];
+        let bb = AABB::from_corners(mins, maxs);
+        found.into_iter().flat_map(move |(tree, blobs)| {
+            tree.locate_in_envelope(&bb)
+                .map(move |r| MetadataRef::new(blobs, r))
+        })
+    }
+    /// Lazily iterate over interpreted data matching a bounding box; the
+    /// interpreting counterpart of `iter_metadata_blobs_in_bb`. As there,
+    /// an unknown designation yields an empty iterator.
+    #[allow(clippy::too_many_arguments)]
+    pub fn iter_metadata_in_bb(
+        &self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        epsilon: Option<f64>,
+    ) -> impl Iterator<Item = Datum> {
+        let interpreter = self.interpreters.get(designation);
+        self.iter_metadata_blobs_in_bb(
+            xmin,
+            xmax,
+            ymin,
+            ymax,
+            zmin,
+            zmax,
+            tmin,
+            tmax,
+            designation,
+            epsilon,
+        )
+        .filter_map(move |m| interpreter.map(|i| i.interpret_enum(m.buffer).unwrap()))
+    }
+    /// Insert a datum, taking ownership of its buffer. Unlike
+    /// `insert_metadata`, the buffer is moved into the tree rather than
+    /// copied, so the hot insert path performs no per-datum allocations.
+    #[allow(clippy::too_many_arguments)]
+    pub fn insert_metadata_owned(
+        &mut self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        buffer: Vec<u8>,
+    ) -> Result<()> {
+        #[cfg(feature = "instrumentation")]
+        let start = std::time::Instant::now();
+        self.log_metadata(
+            xmin,
+            xmax,
+            ymin,
+            ymax,
+            zmin,
+            zmax,
+            tmin,
+            tmax,
+            designation,
+            &buffer,
+        )?;
+        let designation_id = self.intern_designation(designation);
+        self.note_indexed_insert(designation, &buffer);
+        let blob_store = &mut self.blobs[designation_id as usize];
+        let blob = blob_store.len() as u32;
+        blob_store.push(buffer);
+        self.trees[designation_id as usize].insert(EnvelopeRef {
+            mins: [xmin, ymin, zmin, tmin],
+            maxs: [xmax, ymax, zmax, tmax],
+            blob,
+        });
+        #[cfg(feature = "instrumentation")]
+        self.instruments.insert_latency.record(start.elapsed());
+        self.maybe_compact()
+    }
+    /// Walk one designation's tree, computing entry count, depth, internal
+    /// node count, and mean children per internal node.
+    #[cfg(feature = "instrumentation")]
+    fn tree_shape(&self, id: usize) -> TreeShape {
+        fn walk(
+            node: &rstar::ParentNode<EnvelopeRef>,
+            depth: usize,
+            nodes: &mut usize,
+            children: &mut usize,
+            max_depth: &mut usize,
+        ) {
+            *nodes += 1;
+            *children += node.children().len();
+            *max_depth = (*max_depth).max(depth);
+            for child in node.children() {
+                if let rstar::RTreeNode::Parent(parent) = child {
+                    walk(parent, depth + 1, nodes, children, max_depth);
+                }
+            }
+        }
+        let tree = &self.trees[id];
+        let mut nodes = 0;
+        let mut children = 0;
+        let mut depth = 0;
+        if tree.size() > 0 {
+            walk(tree.root(), 1, &mut nodes, &mut children, &mut depth);
+        }
+        TreeShape {
+            designation: self.designation_names[id].clone(),
+            entries: tree.size(),
+            depth,
+            nodes,
+            mean_node_occupancy: if nodes == 0 {
+                0.0
+            } else {
+                children as f64 / nodes as f64
+            },
+        }
+    }
+    /// Fetch the raw blobs of the `k` data nearest to a point, closest
+    /// first, via one nearest-neighbor traversal of the designation's
+    /// tree.
+    pub fn get_nearest_metadata_blobs(
+        &self,
+        x: f64,
+        y: f64,
+        z: f64,
+        t: f64,
+        designation: &str,
+        k: usize,
+    ) -> Result<Vec<&Vec<u8>>> {
+        let (tree, blobs) = match self.designation_ids.get(designation) {
+            Some(id) => (&self.trees[*id as usize], &self.blobs[*id as usize]),
+            None => return Ok(Vec::new()),
+        };
+        Ok(tree
+            .nearest_neighbor_iter(&[x, y, z, t])
+            .take(k)
+            .map(|r| &blobs[r.blob as usize])
+            .collect())
+    }
+    /// As `get_nearest_metadata_blobs`, but paired with each entry's
+    /// squared euclidean distance to the query point, so callers merging
+    /// results from several trees can re-rank them.
+    pub fn get_nearest_metadata_blobs_with_distance(
+        &self,
+        x: f64,
+        y: f64,
+        z: f64,
+        t: f64,
+        designation: &str,
+        k: usize,
+    ) -> Result<Vec<(f64, &Vec<u8>)>> {
+        let (tree, blobs) = match self.designation_ids.get(designation) {
+            Some(id) => (&self.trees[*id as usize], &self.blobs[*id as usize]),
+            None => return Ok(Vec::new()),
+        };
+        Ok(tree
+            .nearest_neighbor_iter_with_distance_2(&[x, y, z, t])
+            .take(k)
+            .map(|(r, d2)| (d2, &blobs[r.blob as usize]))
+            .collect())
+    }
+    /// Interpret every blob matching a bounding box into one columnar
+    /// batch, decoding each member into a contiguous vector rather than
+    /// one map per blob. Intended for consumers that hand whole columns
+    /// across a language boundary.
+    #[allow(clippy::too_many_arguments)]
+    pub fn get_columnar_metadata_in_bb(
+        &self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        epsilon: Option<f64>,
+    ) -> Result<ColumnarData> {
+        let interpreter =
+            self.interpreters
+                .get(designation)
+                .ok_or_else(|| DatabaseError::ElucidatorError {
+                    reason: ElucidatorError::Unsupported {
+                        reason: format!("No spec registered for designation {designation}"),
+                    },
+                })?;
+        let blobs: Vec<&[u8]> = self
+            .iter_metadata_blobs_in_bb(
+                xmin, xmax, ymin, ymax, zmin, zmax, tmin, tmax, designation, epsilon,
+            )
+            .map(|m| m.buffer.as_slice())
+            .collect();
+        Ok(interpreter.interpret_many(&blobs)?)
+    }
+    /// Write the database to `filename` in the native snapshot format: a
+    /// header with the interned designation table, fixed-width entry
+    /// records, and every blob back to back in one contiguous region.
+    pub fn save_snapshot(&self, filename: &str) -> Result<()> {
+        self.save_snapshot_with_generation(filename, 0)
+    }
+    /// As `save_snapshot`, stamping the write-ahead log generation the
+    /// snapshot covers; replay skips log records at or below it.
+    fn save_snapshot_with_generation(&self, filename: &str, generation: u64) -> Result<()> {
+        let mut out = BufWriter::new(File::create(filename)?);
+        out.write_all(SNAPSHOT_MAGIC)?;
+        out.write_all(&SNAPSHOT_VERSION.to_le_bytes())?;
+        out.write_all(&generation.to_le_bytes())?;
+        out.write_all(&(self.trees.len() as u32).to_le_bytes())?;
+        for (id, tree) in self.trees.iter().enumerate() {
+            let name = &self.designation_names[id];
+            let spec = self
+                .designations
+                .get(name)
+                .map(|s| s.to_string())
+                .unwrap_or_default();
+            out.write_all(&(name.len() as u64).to_le_bytes())?;
+            out.write_all(name.as_bytes())?;
+            out.write_all(&(spec.len() as u64).to_le_bytes())?;
+            out.write_all(spec.as_bytes())?;
+            out.write_all(&(tree.size() as u64).to_le_bytes())?;
+        }
+        let mut blob_offset: u64 = 0;
+        for (id, tree) in self.trees.iter().enumerate() {
+            let blobs = &self.blobs[id];
+            for r in tree.iter() {
+                let buffer = &blobs[r.blob as usize];
+                for bound in [
+                    r.mins[0], r.maxs[0], r.mins[1], r.maxs[1], r.mins[2], r.maxs[2], r.mins[3],
+                    r.maxs[3],
+                ] {
+                    out.write_all(&bound.to_le_bytes())?;
+                }
+                out.write_all(&(buffer.len() as u64).to_le_bytes())?;
+                out.write_all(&blob_offset.to_le_bytes())?;
+                blob_offset += buffer.len() as u64;
+            }
+        }
+        for (id, tree) in self.trees.iter().enumerate() {
+            let blobs = &self.blobs[id];
+            for r in tree.iter() {
+                out.write_all(&blobs[r.blob as usize])?;
+            }
+        }
+        out.flush()?;
+        Ok(())
+    }
+    /// Load a database from a native snapshot. The file is parsed eagerly
+    /// through a read-only memory mapping, so parsing borrows from the
+    /// mapping rather than an intermediate buffer, but every blob is
+    /// copied out and the whole file is touched before this returns.
+    pub fn from_snapshot(filename: &str) -> Result<Self> {
+        Ok(Self::from_snapshot_with_generation(filename)?.0)
+    }
+    /// As `from_snapshot`, also returning the write-ahead log generation
+    /// the snapshot covers.
+    fn from_snapshot_with_generation(filename: &str) -> Result<(Self, u64)> {
+        let file = File::open(filename)?;
+        // Safety: the mapping is only ever read as plain bytes.
+        let map = unsafe { Mmap::map(&file)? };
+        Self::parse_snapshot(&map)
+    }
+    fn parse_snapshot(data: &[u8]) -> Result<(Self, u64)> {
+        let mut pos = 0;
+        if snapshot_take(data, &mut pos, SNAPSHOT_MAGIC.len())? != SNAPSHOT_MAGIC {
+            return Err(DatabaseError::IOError {
+                reason: "Not an elucidator snapshot file".to_string(),
+            });
+        }
+        let version = snapshot_u32(data, &mut pos)?;
+        if version != SNAPSHOT_VERSION {
+            return Err(DatabaseError::VersionError {
+                reason: format!(
+                    "Snapshot version {version} is not supported; expected {SNAPSHOT_VERSION}"
+                ),
+            });
+        }
+        let generation = snapshot_u64(data, &mut pos)?;
+        let n_designations = snapshot_u32(data, &mut pos)? as usize;
+        let mut db = RTreeDatabase::new(None, None)?;
+        let mut counts: Vec<(u32, usize)> = Vec::with_capacity(n_designations);
+        for _ in 0..n_designations {
+            let name = snapshot_str(data, &mut pos)?;
+            let spec = snapshot_str(data, &mut pos)?;
+            let count = snapshot_u64(data, &mut pos)? as usize;
+            if !spec.is_empty() {
+                db.insert_spec_text(&name, &spec)?;
+            }
+            let id = db.intern_designation(&name);
+            counts.push((id, count));
+        }
+        let total: usize = counts.iter().map(|(_, count)| count).sum();
+        let blob_region = pos + total * SNAPSHOT_RECORD_BYTES;
+        for (id, count) in counts {
+            let mut entries = Vec::with_capacity(count);
+            for _ in 0..count {
+                let xmin = snapshot_f64(data, &mut pos)?;
+                let xmax = snapshot_f64(data, &mut pos)?;
+                let ymin = snapshot_f64(data, &mut pos)?;
+                let ymax = snapshot_f64(data, &mut pos)?;
+                let zmin = snapshot_f64(data, &mut pos)?;
+                let zmax = snapshot_f64(data, &mut pos)?;
+                let tmin = snapshot_f64(data, &mut pos)?;
+                let tmax = snapshot_f64(data, &mut pos)?;
+                let n_bytes = snapshot_u64(data, &mut pos)? as usize;
+                let offset = snapshot_u64(data, &mut pos)? as usize;
+                let mut blob_pos = blob_region + offset;
+                let buffer = snapshot_take(data, &mut blob_pos, n_bytes)?.to_vec();
+                entries.push(TreeEntry {
+                    xmin,
+                    xmax,
+                    ymin,
+                    ymax,
+                    zmin,
+                    zmax,
+                    tmin,
+                    tmax,
+                    buffer,
+                });
+            }
+            db.bulk_insert(id, entries);
+        }
+        Ok((db, generation))
+    }
+    /// Open a database persisted by write-ahead logging at `filename`.
+    /// The snapshot (if present) is loaded, the append-only log at
+    /// `<filename>.log` is replayed on top, and the log is left open so
+    /// subsequent inserts are appended as they happen. A torn final
+    /// record from an interrupted write is discarded during replay.
+    pub fn open_wal(filename: &str) -> Result<Self> {
+        let log_path = format!("{filename}.log");
+        let (mut db, snapshot_generation) = if std::path::Path::new(filename).exists() {
+            Self::from_snapshot_with_generation(filename)?
+        } else {
+            (Self::new(None, None)?, 0)
+        };
+        let pending = match std::fs::read(&log_path) {
+            Ok(bytes) => db.replay_log(&bytes, snapshot_generation)?,
+            Err(_) => 0,
+        };
+        let writer = BufWriter::new(
+            std::fs::OpenOptions::new()
+                .create(true)
+                .append(true)
+                .open(&log_path)?,
+        );
+        db.wal = Some(WriteAheadLog {
+            snapshot_path: filename.to_string(),
+            log_path,
+            writer,
+            generation: snapshot_generation + 1,
+            pending,
+            compaction_threshold: WAL_COMPACTION_THRESHOLD,
+        });
+        Ok(db)
+    }
+    /// Flush buffered log records to the operating system.
+    pub fn flush_wal(&mut self) -> Result<()> {
+        if let Some(wal) = self.wal.as_mut() {
+            wal.writer.flush()?;
+        }
+        Ok(())
+    }
+    /// Compact the write-ahead log into the snapshot. The snapshot is
+    /// written to a temporary file and renamed into place before the log
+    /// is truncated, and it records the generation of the records it
+    /// folded in; replay skips records at or below that generation, so a
+    /// crash between the rename and the truncation cannot duplicate
+    /// records.
+    pub fn compact_wal(&mut self) -> Result<()> {
+        let (snapshot_path, log_path, generation) = match self.wal.as_mut() {
+            Some(wal) => {
+                wal.writer.flush()?;
+                (
+                    wal.snapshot_path.clone(),
+                    wal.log_path.clone(),
+                    wal.generation,
+                )
+            }
+            None => return Ok(()),
+        };
+        let staging = format!("{snapshot_path}.tmp");
+        self.save_snapshot_with_generation(&staging, generation)?;
+        std::fs::rename(&staging, &snapshot_path)?;
+        let writer = BufWriter::new(File::create(&log_path)?);
+        let wal = self.wal.as_mut().unwrap();
+        wal.writer = writer;
+        wal.generation = generation + 1;
+        wal.pending = 0;
+        Ok(())
+    }
+    /// Replay log records onto the tree, skipping records at or below the
+    /// snapshot's generation, returning how many applied.
+    fn replay_log(&mut self, data: &[u8], snapshot_generation: u64) -> Result<usize> {
+        let mut pos = 0;
+        let mut count = 0;
+        while pos < data.len() {
+            match self.replay_record(data, &mut pos, snapshot_generation) {
+                Ok(()) => count += 1,
+                // A torn tail from an interrupted append is expected;
+                // everything before it has been applied.
+                Err(DatabaseError::IOError { .. }) => break,
+                Err(e) => return Err(e),
+            }
+        }
+        Ok(count)
+    }
+    fn replay_record(
+        &mut self,
+        data: &[u8],
+        pos: &mut usize,
+        snapshot_generation: u64,
+    ) -> Result<()> {
+        let tag = snapshot_take(data, pos, 1)?[0];
+        let generation = snapshot_u64(data, pos)?;
+        // Records the snapshot already covers are parsed past but not
+        // reapplied, so replay is idempotent across compaction.
+        let stale = generation <= snapshot_generation;
+        match tag {
+            WAL_SPEC_TAG => {
+                let designation = snapshot_str(data, pos)?;
+                let spec = snapshot_str(data, pos)?;
+                if stale {
+                    return Ok(());
+                }
+                self.insert_spec_text(&designation, &spec)
+            }
+            WAL_METADATA_TAG => {
+                let designation = snapshot_str(data, pos)?;
+                let xmin = snapshot_f64(data, pos)?;
+                let xmax = snapshot_f64(data, pos)?;
+                let ymin = snapshot_f64(data, pos)?;
+                let ymax = snapshot_f64(data, pos)?;
+                let zmin = snapshot_f64(data, pos)?;
+                let zmax = snapshot_f64(data, pos)?;
+                let tmin = snapshot_f64(data, pos)?;
+                let tmax = snapshot_f64(data, pos)?;
+                let n_bytes = snapshot_u64(data, pos)? as usize;
+                let buffer = snapshot_take(data, pos, n_bytes)?;
+                if stale {
+                    return Ok(());
+                }
+                self.insert_metadata_owned(
+                    xmin,
+                    xmax,
+                    ymin,
+                    ymax,
+                    zmin,
+                    zmax,
+                    tmin,
+                    tmax,
+                    &designation,
+                    buffer.to_vec(),
+                )
+            }
+            tag => Err(DatabaseError::IOError {
+                reason: format!("Unknown write-ahead log record tag {tag}"),
+            }),
+        }
+    }
+    /// Append a spec insertion to the log, if one is attached.
+    fn log_spec(&mut self, designation: &str, spec: &str) -> Result<()> {
+        if let Some(wal) = self.wal.as_mut() {
+            wal.writer.write_all(&[WAL_SPEC_TAG])?;
+            wal.writer.write_all(&wal.generation.to_le_bytes())?;
+            wal_str(&mut wal.writer, designation)?;
+            wal_str(&mut wal.writer, spec)?;
+            wal.pending += 1;
+        }
+        Ok(())
+    }
+    /// Append a metadata insertion to the log, if one is attached.
+    #[allow(clippy::too_many_arguments)]
+    fn log_metadata(
+        &mut self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        buffer: &[u8],
+    ) -> Result<()> {
+        if let Some(wal) = self.wal.as_mut() {
+            wal.writer.write_all(&[WAL_METADATA_TAG])?;
+            wal.writer.write_all(&wal.generation.to_le_bytes())?;
+            wal_str(&mut wal.writer, designation)?;
+            for bound in [xmin, xmax, ymin, ymax, zmin, zmax, tmin, tmax] {
+                wal.writer.write_all(&bound.to_le_bytes())?;
+            }
+            wal.writer.write_all(&(buffer.len() as u64).to_le_bytes())?;
+            wal.writer.write_all(buffer)?;
+            wal.pending += 1;
+        }
+        Ok(())
+    }
+    /// Compact once enough records accumulate since the last compaction.
+    fn maybe_compact(&mut self) -> Result<()> {
+        let due = self
+            .wal
+            .as_ref()
+            .is_some_and(|wal| wal.pending >= wal.compaction_threshold);
+        if due {
+            self.compact_wal()?;
+        }
+        Ok(())
+    }
+}
+
+/// Write a length-prefixed string in the snapshot/log encoding.
+fn wal_str<W: Write>(out: &mut W, s: &str) -> Result<()> {
+    out.write_all(&(s.len() as u64).to_le_bytes())?;
+    out.write_all(s.as_bytes())?;
+    Ok(())
+}
+
+/// Take `n` bytes from the snapshot, advancing the cursor, or report a
+/// truncated file.
+fn snapshot_take<'a>(data: &'a [u8], pos: &mut usize, n: usize) -> Result<&'a [u8]> {
+    let end = pos
+        .checked_add(n)
+        .filter(|end| *end <= data.len())
+        .ok_or_else(|| DatabaseError::IOError {
+            reason: "Snapshot file is truncated".to_string(),
+        })?;
+    let bytes = &data[*pos..end];
+    *pos = end;
+    Ok(bytes)
+}
+
+fn snapshot_u32(data: &[u8], pos: &mut usize) -> Result<u32> {
+    Ok(u32::from_le_bytes(
+        snapshot_take(data, pos, 4)?.try_into().unwrap(),
+    ))
+}
+
+fn snapshot_u64(data: &[u8], pos: &mut usize) -> Result<u64> {
+    Ok(u64::from_le_bytes(
+        snapshot_take(data, pos, 8)?.try_into().unwrap(),
+    ))
+}
+
+fn snapshot_f64(data: &[u8], pos: &mut usize) -> Result<f64> {
+    Ok(f64::from_le_bytes(
+        snapshot_take(data, pos, 8)?.try_into().unwrap(),
+    ))
+}
+
+fn snapshot_str(data: &[u8], pos: &mut usize) -> Result<String> {
+    let n = snapshot_u64(data, pos)? as usize;
+    let bytes = snapshot_take(data, pos, n)?;
+    String::from_utf8(bytes.to_vec()).map_err(|e| DatabaseError::IOError {
+        reason: format!("Snapshot contains invalid UTF-8: {e}"),
+    })
+}
+
 impl RTreeObject for &MetadataClone {
     type Envelope = AABB<[f64; 4]>;
 
@@ -88,22 +1195,183 @@ impl RTreeObject for MetadataClone {
     }
 }
 
+/// Builder for populating a new `RTreeDatabase` via a single bulk load,
+/// which is substantially faster than incremental insertion and produces a
+/// better-packed tree.
+pub struct RTreeDatabaseBuilder {
+    db: RTreeDatabase,
+    /// Queued entries per designation, indexed by interned designation ID
+    entries: Vec<Vec<TreeEntry>>,
+}
+
+impl RTreeDatabaseBuilder {
+    pub fn new() -> Self {
+        RTreeDatabaseBuilder {
+            db: RTreeDatabase {
+                trees: Vec::new(),
+                blobs: Vec::new(),
+                designations: HashMap::new(),
+                interpreters: HashMap::new(),
+                designation_ids: HashMap::new(),
+                designation_names: Vec::new(),
+                wal: None,
+                member_indexes: HashMap::new(),
+                #[cfg(feature = "instrumentation")]
+                instruments: Instruments::default(),
+            },
+            entries: Vec::new(),
+        }
+    }
+    pub fn spec_text(mut self, designation: &str, spec: &str) -> Result<Self> {
+        self.db.insert_spec_text(designation, spec)?;
+        Ok(self)
+    }
+    /// Queue a datum for bulk loading, taking ownership of its buffer.
+    #[allow(clippy::too_many_arguments)]
+    pub fn metadata_owned(
+        mut self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        buffer: Vec<u8>,
+    ) -> Self {
+        let designation_id = self.db.intern_designation(designation);
+        if self.entries.len() <= designation_id as usize {
+            self.entries.resize_with(designation_id as usize + 1, Vec::new);
+        }
+        self.entries[designation_id as usize].push(TreeEntry {
+            xmin,
+            xmax,
+            ymin,
+            ymax,
+            zmin,
+            zmax,
+            tmin,
+            tmax,
+            buffer,
+        });
+        self
+    }
+    pub fn build(mut self) -> RTreeDatabase {
+        for (id, group) in self.entries.into_iter().enumerate() {
+            self.db.bulk_insert(id as u32, group);
+        }
+        self.db
+    }
+}
+
+impl Default for RTreeDatabaseBuilder {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
 impl Database for RTreeDatabase {
     fn new(_: Option<&str>, _: Option<&DatabaseConfig>) -> Result<Self> {
         Ok(Self {
-            rtree: RTree::new(),
+            trees: Vec::new(),
+            blobs: Vec::new(),
             designations: HashMap::new(),
+            interpreters: HashMap::new(),
+            designation_ids: HashMap::new(),
+            designation_names: Vec::new(),
+            wal: None,
+            member_indexes: HashMap::new(),
+            #[cfg(feature = "instrumentation")]
+            instruments: Instruments::default(),
         })
     }
     fn from_path(filename: &str) -> Result<Self> {
+        let mut magic = [0; SNAPSHOT_MAGIC.len()];
+        let is_snapshot = File::open(filename)?.read_exact(&mut magic).is_ok()
+            && &magic == SNAPSHOT_MAGIC;
+        if is_snapshot {
+            return Self::from_snapshot(filename);
+        }
         let sqlite = SqlDatabase::from_path(filename)?;
         let designations = sqlite.get_designations();
-        let mds = sqlite.get_all_metadata()?;
-        let rtree = RTree::bulk_load(mds);
-        Ok(RTreeDatabase {
-            rtree,
+        let interpreters = designations
+            .iter()
+            .map(|(d, spec)| (d.clone(), spec.compile()))
+            .collect();
+        let mut db = RTreeDatabase {
+            trees: Vec::new(),
+            blobs: Vec::new(),
             designations,
-        })
+            interpreters,
+            designation_ids: HashMap::new(),
+            designation_names: Vec::new(),
+            wal: None,
+            member_indexes: HashMap::new(),
+            #[cfg(feature = "instrumentation")]
+            instruments: Instruments::default(),
+        };
+        let decoders = sqlite.raw_decoders()?;
+        let chunks = sqlite.stream_raw_metadata();
+        let mut groups: Vec<Vec<TreeEntry>> = Vec::new();
+        for chunk in chunks {
+            // Decode this chunk across the pool while the fetch thread
+            // reads the next one.
+            let entries = chunk?
+                .into_par_iter()
+                .map(|row| {
+                    let buffer = match decoders.get(&row.designation) {
+                        Some(Some(decoder)) => decoder.decode(&row.stored)?,
+                        _ => row.stored,
+                    };
+                    Ok((
+                        row.designation,
+                        TreeEntry {
+                            xmin: row.xmin,
+                            xmax: row.xmax,
+                            ymin: row.ymin,
+                            ymax: row.ymax,
+                            zmin: row.zmin,
+                            zmax: row.zmax,
+                            tmin: row.tmin,
+                            tmax: row.tmax,
+                            buffer,
+                        },
+                    ))
+                })
+                .collect::<Result<Vec<_>>>()?;
+            for (designation, entry) in entries {
+                let id = db.intern_designation(&designation) as usize;
+                if groups.len() <= id {
+                    groups.resize_with(id + 1, Vec::new);
+                }
+                groups[id].push(entry);
+            }
+        }
+        // Each designation's tree packs independently of the others, so
+        // the bulk loads run in parallel too.
+        let built: Vec<(RTree<EnvelopeRef>, Vec<Vec<u8>>)> = groups
+            .into_par_iter()
+            .map(|group| {
+                let mut blobs = Vec::with_capacity(group.len());
+                let mut refs = Vec::with_capacity(group.len());
+                for entry in group {
+                    refs.push(EnvelopeRef {
+                        mins: [entry.xmin, entry.ymin, entry.zmin, entry.tmin],
+                        maxs: [entry.xmax, entry.ymax, entry.zmax, entry.tmax],
+                        blob: blobs.len() as u32,
+                    });
+                    blobs.push(entry.buffer);
+                }
+                (RTree::bulk_load(refs), blobs)
+            })
+            .collect();
+        for (id, (tree, blobs)) in built.into_iter().enumerate() {
+            db.trees[id] = tree;
+            db.blobs[id] = blobs;
+        }
+        Ok(db)
     }
     fn save_as(&self, filename: &str) -> Result<()> {
         let mut sqlite = SqlDatabase::new(Some(filename), None)?;
@@ -111,43 +1379,89 @@ impl Database for RTreeDatabase {
         for (designation, designation_spec) in self.designations.iter() {
             sqlite.insert_spec_text(designation, &designation_spec.to_string())?;
         }
-        let md_results: Result<Vec<()>, crate::error::DatabaseError> = self
-            .rtree
-            .iter()
-            .map(|m| {
+        for (id, tree) in self.trees.iter().enumerate() {
+            let designation = &self.designation_names[id];
+            let blobs = &self.blobs[id];
+            for r in tree.iter() {
                 let md = Metadata {
-                    xmin: m.xmin,
-                    xmax: m.xmax,
-                    ymin: m.ymin,
-                    ymax: m.ymax,
-                    zmin: m.zmin,
-                    zmax: m.zmax,
-                    tmin: m.tmin,
-                    tmax: m.tmax,
-                    designation: &m.designation,
-                    buffer: &m.buffer,
+                    xmin: r.mins[0],
+                    xmax: r.maxs[0],
+                    ymin: r.mins[1],
+                    ymax: r.maxs[1],
+                    zmin: r.mins[2],
+                    zmax: r.maxs[2],
+                    tmin: r.mins[3],
+                    tmax: r.maxs[3],
+                    designation,
+                    buffer: &blobs[r.blob as usize],
                 };
-                sqlite.insert_metadata(&md)
-            })
-            .collect();
-        md_results?;
+                sqlite.insert_metadata(&md)?;
+            }
+        }
         Ok(())
     }
     fn insert_spec_text(&mut self, designation: &str, spec: &str) -> Result<()> {
-        let designation_spec = DesignationSpecification::from_text(spec)?;
+        let designation_spec = DesignationSpecification::from_text_cached(spec)?;
+        self.log_spec(designation, spec)?;
+        self.intern_designation(designation);
+        self.interpreters
+            .insert(designation.to_string(), designation_spec.compile());
         self.designations
             .insert(designation.to_string(), designation_spec);
         Ok(())
     }
     fn insert_metadata(&mut self, datum: &Metadata) -> Result<()> {
-        self.rtree.insert(datum.into());
-        Ok(())
+        self.insert_metadata_owned(
+            datum.xmin,
+            datum.xmax,
+            datum.ymin,
+            datum.ymax,
+            datum.zmin,
+            datum.zmax,
+            datum.tmin,
+            datum.tmax,
+            datum.designation,
+            datum.buffer.into(),
+        )
     }
     fn insert_n_metadata(&mut self, data: &[Metadata]) -> Result<()> {
+        let mut groups: Vec<Vec<TreeEntry>> = Vec::new();
         for datum in data {
-            self.rtree.insert(datum.into());
+            self.log_metadata(
+                datum.xmin,
+                datum.xmax,
+                datum.ymin,
+                datum.ymax,
+                datum.zmin,
+                datum.zmax,
+                datum.tmin,
+                datum.tmax,
+                datum.designation,
+                datum.buffer,
+            )?;
+            let designation_id = self.intern_designation(datum.designation);
+            if groups.len() <= designation_id as usize {
+                groups.resize_with(designation_id as usize + 1, Vec::new);
+            }
+            groups[designation_id as usize].push(TreeEntry {
+                xmin: datum.xmin,
+                xmax: datum.xmax,
+                ymin: datum.ymin,
+                ymax: datum.ymax,
+                zmin: datum.zmin,
+                zmax: datum.zmax,
+                tmin: datum.tmin,
+                tmax: datum.tmax,
+                buffer: datum.buffer.into(),
+            });
         }
-        Ok(())
+        for (id, group) in groups.into_iter().enumerate() {
+            if !group.is_empty() {
+                self.bulk_insert(id as u32, group);
+            }
+        }
+        self.flush_wal()?;
+        self.maybe_compact()
     }
     fn get_metadata_in_bb(
         &self,
@@ -162,22 +1476,57 @@ impl Database for RTreeDatabase {
         designation: &str,
         epsilon: Option<f64>,
     ) -> Result<Vec<Datum>> {
-        let d = self.designations.get(designation).unwrap();
-        let blobs = self.get_metadata_blobs_in_bb(
-            xmin,
-            xmax,
-            ymin,
-            ymax,
-            zmin,
-            zmax,
-            tmin,
-            tmax,
-            designation,
-            epsilon,
-        )?;
-        Ok(blobs.iter().map(|b| d.interpret_enum(b).unwrap()).collect())
+        #[cfg(feature = "instrumentation")]
+        let start = std::time::Instant::now();
+        let interpreter = self.interpreters.get(designation).unwrap();
+        let blobs: Vec<&[u8]> = self
+            .iter_metadata_blobs_in_bb(
+                xmin, xmax, ymin, ymax, zmin, zmax, tmin, tmax, designation, epsilon,
+            )
+            .map(|m| m.buffer.as_slice())
+            .collect();
+        #[cfg(feature = "instrumentation")]
+        let decode_start = std::time::Instant::now();
+        let data: Vec<Datum> = blobs
+            .par_iter()
+            .map(|b| interpreter.interpret_enum(b).unwrap())
+            .collect();
+        #[cfg(feature = "instrumentation")]
+        {
+            use std::sync::atomic::Ordering;
+            let counters = &self.instruments.counters;
+            counters
+                .candidates
+                .fetch_add(blobs.len() as u64, Ordering::Relaxed);
+            counters
+                .decoded
+                .fetch_add(blobs.len() as u64, Ordering::Relaxed);
+            counters.hits.fetch_add(data.len() as u64, Ordering::Relaxed);
+            self.instruments.decode_latency.record(decode_start.elapsed());
+            self.instruments.query_latency.record(start.elapsed());
+        }
+        Ok(data)
     }
 
+    fn get_nearest_metadata(
+        &self,
+        x: f64,
+        y: f64,
+        z: f64,
+        t: f64,
+        designation: &str,
+        k: usize,
+    ) -> Result<Vec<Datum>> {
+        let blobs = self.get_nearest_metadata_blobs(x, y, z, t, designation, k)?;
+        if blobs.is_empty() {
+            return Ok(Vec::new());
+        }
+        let interpreter = self.interpreters.get(designation).unwrap();
+        Ok(blobs
+            .iter()
+            .map(|b| interpreter.interpret_enum(b).unwrap())
+            .collect())
+    }
     fn get_metadata_blobs_in_bb(
         &self,
         xmin: f64,
@@ -190,18 +1539,36 @@ impl Database for RTreeDatabase {
         tmax: f64,
         designation: &str,
         epsilon: Option<f64>,
-    ) -> Result<Vec<&Vec<u8>>> {
-        let eps = epsilon.unwrap_or(0.0);
-        let mins = [xmin - eps, ymin - eps, zmin - eps, tmin - eps];
-        let maxs = [xmax + eps, ymax + eps, zmax + eps, tmax + eps];
-
-        let bb = AABB::from_corners(mins, maxs);
-        Ok(self
-            .rtree
-            .locate_in_envelope(&bb)
-            .filter(|m| m.designation == designation)
-            .map(|m| &m.buffer)
-            .collect())
+    ) -> Result<Vec<Vec<u8>>> {
+        #[cfg(feature = "instrumentation")]
+        let start = std::time::Instant::now();
+        let blobs: Vec<Vec<u8>> = self
+            .iter_metadata_blobs_in_bb(
+                xmin, xmax, ymin, ymax, zmin, zmax, tmin, tmax, designation, epsilon,
+            )
+            .map(|m| m.buffer.clone())
+            .collect();
+        #[cfg(feature = "instrumentation")]
+        {
+            use std::sync::atomic::Ordering;
+            let counters = &self.instruments.counters;
+            counters
+                .candidates
+                .fetch_add(blobs.len() as u64, Ordering::Relaxed);
+            counters.hits.fetch_add(blobs.len() as u64, Ordering::Relaxed);
+            self.instruments.query_latency.record(start.elapsed());
+        }
+        Ok(blobs)
+    }
+    #[cfg(feature = "instrumentation")]
+    fn instrumentation_report(&self) -> Option<InstrumentationReport> {
+        Some(InstrumentationReport {
+            insert_latency: self.instruments.insert_latency.snapshot(),
+            query_latency: self.instruments.query_latency.snapshot(),
+            decode_latency: self.instruments.decode_latency.snapshot(),
+            counters: self.instruments.counters.snapshot(),
+            trees: (0..self.trees.len()).map(|id| self.tree_shape(id)).collect(),
+        })
     }
 }
 
@@ -245,6 +1612,26 @@ mod test {
             .collect()
     }
 
+    /// Every stored datum as (bounds, blob), for order-insensitive
+    /// round-trip comparisons.
+    fn all_metadata(db: &RTreeDatabase) -> Vec<([f64; 8], Vec<u8>)> {
+        db.trees
+            .iter()
+            .enumerate()
+            .flat_map(|(id, tree)| {
+                tree.iter().map(move |r| {
+                    (
+                        [
+                            r.mins[0], r.maxs[0], r.mins[1], r.maxs[1], r.mins[2], r.maxs[2],
+                            r.mins[3], r.maxs[3],
+                        ],
+                        db.blobs[id][r.blob as usize].clone(),
+                    )
+                })
+            })
+            .collect()
+    }
+
     mod config {}
 
     mod database {
@@ -383,6 +1770,405 @@ mod test {
             pretty_assertions::assert_eq!(result, Ok(()));
         }
 
+        #[test]
+        fn insert_owned_ok() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+
+            let designation = "Foo";
+            let spec = "foo: u8, bar: f32";
+            let _ = db.insert_spec_text(designation, spec);
+
+            let buffer: Vec<u8> = vec![100, 0, 0, 128, 63];
+            let result = db.insert_metadata_owned(
+                0.0,
+                1.0,
+                0.0,
+                1.0,
+                0.0,
+                1.0,
+                0.0,
+                1.0,
+                designation,
+                buffer,
+            );
+            pretty_assertions::assert_eq!(result, Ok(()));
+
+            let found = db
+                .get_metadata_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None)
+                .unwrap();
+            let expected: Vec<HashMap<&str, DataValue>> = vec![HashMap::from([
+                ("foo", DataValue::Byte(100)),
+                ("bar", DataValue::Float32(1.0)),
+            ])];
+            pretty_assertions::assert_eq!(found, expected);
+        }
+
+        #[test]
+        fn insert_owned_interns_designation() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+
+            let designation = "Foo";
+            let spec = "foo: u8";
+            let _ = db.insert_spec_text(designation, spec);
+
+            for val in 0..3u8 {
+                let _ = db.insert_metadata_owned(
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    designation,
+                    vec![val],
+                );
+            }
+            let id = *db.designation_ids.get(designation).unwrap();
+            assert_eq!(db.trees[id as usize].size(), 3);
+        }
+
+        #[test]
+        fn builder_bulk_load_ok() {
+            let mut builder = RTreeDatabase::builder()
+                .spec_text("Foo", "foo: u8")
+                .unwrap();
+            for val in 0..10u8 {
+                let coord = f64::from(val);
+                builder = builder.metadata_owned(
+                    coord,
+                    coord,
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    "Foo",
+                    vec![val],
+                );
+            }
+            let db = builder.build();
+            assert_eq!(db.size(), 10);
+            let blobs = db
+                .get_metadata_blobs_in_bb(0.0, 4.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, "Foo", None)
+                .unwrap();
+            assert_eq!(blobs.len(), 5);
+        }
+
+        #[test]
+        fn insert_n_into_nonempty_ok() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            let designation = "Foo";
+            let _ = db.insert_spec_text(designation, "foo: u8");
+
+            let buffer: &[u8; 1] = &[1; 1];
+            let first = Metadata {
+                xmin: 0.0,
+                xmax: 0.0,
+                ymin: 0.0,
+                ymax: 0.0,
+                zmin: 0.0,
+                zmax: 0.0,
+                tmin: 0.0,
+                tmax: 0.0,
+                designation,
+                buffer,
+            };
+            let _ = db.insert_metadata(&first);
+
+            let buffer: &[u8; 1] = &[2; 1];
+            let mut second = first.clone();
+            second.buffer = buffer;
+            let buffer: &[u8; 1] = &[3; 1];
+            let mut third = first.clone();
+            third.buffer = buffer;
+            let result = db.insert_n_metadata(&[second, third]);
+
+            pretty_assertions::assert_eq!(result, Ok(()));
+            assert_eq!(db.size(), 3);
+            let blobs = db
+                .get_metadata_blobs_in_bb(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, "Foo", None)
+                .unwrap();
+            assert_eq!(blobs.len(), 3);
+        }
+
+        #[test]
+        fn bb_search_partitioned_by_designation() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            let _ = db.insert_spec_text("Foo", "foo: u8");
+            let _ = db.insert_spec_text("Bar", "bar: u8");
+
+            let _ =
+                db.insert_metadata_owned(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", vec![1]);
+            let _ =
+                db.insert_metadata_owned(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Bar", vec![2]);
+
+            let foo_blobs = db
+                .get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None)
+                .unwrap();
+            pretty_assertions::assert_eq!(foo_blobs, vec![vec![1]]);
+            let bar_blobs = db
+                .get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Bar", None)
+                .unwrap();
+            pretty_assertions::assert_eq!(bar_blobs, vec![vec![2]]);
+        }
+
+        #[test]
+        fn predicate_filters_members() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            let _ = db.insert_spec_text("Foo", "foo: u8");
+            for val in 0..10u8 {
+                let _ = db.insert_metadata_owned(
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    "Foo",
+                    vec![val],
+                );
+            }
+
+            let predicates = vec![MemberPredicate::new("foo", PredicateOp::Gt, 7.0)];
+            let result = db
+                .get_metadata_in_bb_where(
+                    0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None, &predicates,
+                )
+                .unwrap();
+
+            let mut values: Vec<u8> = result
+                .iter()
+                .map(|d| match d.get("foo").unwrap() {
+                    DataValue::Byte(v) => *v,
+                    _ => unreachable!(),
+                })
+                .collect();
+            values.sort();
+            pretty_assertions::assert_eq!(values, vec![8, 9]);
+        }
+
+        #[test]
+        fn bb_search_where_bad_predicate_err() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            let _ = db.insert_spec_text("Foo", "foo: u8, name: string");
+            let _ =
+                db.insert_metadata_owned(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", {
+                    let mut buffer = vec![5];
+                    buffer.extend((2u64).to_le_bytes());
+                    buffer.extend(b"hi");
+                    buffer
+                });
+
+            // A typoed member errors instead of silently matching nothing
+            let predicates = vec![MemberPredicate::new("fool", PredicateOp::Gt, 1.0)];
+            let result = db.get_metadata_in_bb_where(
+                0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None, &predicates,
+            );
+            assert!(result.is_err());
+
+            // So does a member that exists but cannot compare numerically
+            let predicates = vec![MemberPredicate::new("name", PredicateOp::Eq, 1.0)];
+            let result = db.get_metadata_in_bb_where(
+                0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None, &predicates,
+            );
+            assert!(result.is_err());
+        }
+
+        #[test]
+        fn member_index_prunes_out_of_range() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            let _ = db.insert_spec_text("Foo", "foo: u8");
+            let _ =
+                db.insert_metadata_owned(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", vec![5]);
+            db.declare_member_index("Foo", "foo").unwrap();
+            let _ =
+                db.insert_metadata_owned(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", vec![9]);
+
+            let predicates = vec![MemberPredicate::new("foo", PredicateOp::Gt, 9.0)];
+            let result = db
+                .get_metadata_in_bb_where(
+                    0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None, &predicates,
+                )
+                .unwrap();
+            assert!(result.is_empty());
+
+            let predicates = vec![MemberPredicate::new("foo", PredicateOp::Ge, 9.0)];
+            let result = db
+                .get_metadata_in_bb_where(
+                    0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None, &predicates,
+                )
+                .unwrap();
+            assert_eq!(result.len(), 1);
+        }
+
+        #[cfg(feature = "instrumentation")]
+        #[test]
+        fn instrumentation_records_inserts_and_queries() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            let _ = db.insert_spec_text("Foo", "foo: u8");
+            for val in 0..10u8 {
+                let lo = f64::from(val);
+                let _ = db.insert_metadata_owned(
+                    lo,
+                    lo + 0.5,
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    "Foo",
+                    vec![val],
+                );
+            }
+            let _ = db
+                .get_metadata_in_bb(-1.0, 20.0, -1.0, 2.0, -1.0, 2.0, -1.0, 2.0, "Foo", None)
+                .unwrap();
+
+            let report = db.instrumentation_report().unwrap();
+
+            assert_eq!(report.insert_latency.count, 10);
+            assert_eq!(report.query_latency.count, 1);
+            assert_eq!(report.counters.candidates, 10);
+            assert_eq!(report.counters.decoded, 10);
+            assert_eq!(report.counters.hits, 10);
+            assert_eq!(report.trees.len(), 1);
+            assert_eq!(report.trees[0].entries, 10);
+            assert!(report.trees[0].depth >= 1);
+            assert!(!report.to_json().is_empty());
+        }
+
+        #[test]
+        fn memory_usage_reports_per_designation() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            let _ = db.insert_spec_text("Foo", "foo: u8");
+            let _ = db.insert_spec_text("Bar", "bar: u32");
+            for val in 0..3u8 {
+                let _ = db.insert_metadata_owned(
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    "Foo",
+                    vec![val],
+                );
+            }
+            let _ =
+                db.insert_metadata_owned(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Bar", vec![0; 4]);
+
+            let report = db.memory_usage();
+
+            assert_eq!(report.len(), 2);
+            let foo = report.iter().find(|u| u.designation == "Foo").unwrap();
+            assert_eq!(foo.count, 3);
+            assert_eq!(foo.blob_bytes, 3);
+            assert_eq!(foo.envelope_bytes, 3 * std::mem::size_of::<EnvelopeRef>());
+            let bar = report.iter().find(|u| u.designation == "Bar").unwrap();
+            assert_eq!(bar.count, 1);
+            assert_eq!(bar.blob_bytes, 4);
+        }
+
+        #[test]
+        fn declare_index_unknown_member_err() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            let _ = db.insert_spec_text("Foo", "foo: u8");
+            assert!(db.declare_member_index("Foo", "bar").is_err());
+            assert!(db.declare_member_index("Bar", "foo").is_err());
+        }
+
+        #[test]
+        fn bb_batch_search_ok() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            let _ = db.insert_spec_text("Foo", "foo: u8");
+            for val in 0..4u8 {
+                let coord = f64::from(val);
+                let _ = db.insert_metadata_owned(
+                    coord,
+                    coord,
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    0.0,
+                    "Foo",
+                    vec![val],
+                );
+            }
+            let unit_bb = |xmin: f64, xmax: f64| crate::database::BoundingBox {
+                xmin,
+                xmax,
+                ymin: 0.0,
+                ymax: 0.0,
+                zmin: 0.0,
+                zmax: 0.0,
+                tmin: 0.0,
+                tmax: 0.0,
+            };
+            let boxes = vec![unit_bb(0.0, 1.0), unit_bb(2.0, 3.0), unit_bb(10.0, 11.0)];
+            let results = db.get_metadata_in_bbs(&boxes, "Foo", None).unwrap();
+            assert_eq!(results.len(), 3);
+            assert_eq!(results[0].len(), 2);
+            assert_eq!(results[1].len(), 2);
+            assert_eq!(results[2].len(), 0);
+        }
+
+        #[test]
+        fn bb_iter_streams_hits() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            let _ = db.insert_spec_text("Foo", "foo: u8");
+            for val in 0..5u8 {
+                let _ = db.insert_metadata_owned(
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    0.0,
+                    1.0,
+                    "Foo",
+                    vec![val],
+                );
+            }
+            let count = db
+                .iter_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None)
+                .count();
+            assert_eq!(count, 5);
+            // Early exit without materializing the full result set
+            let first = db
+                .iter_metadata_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None)
+                .next()
+                .unwrap();
+            assert!(first.contains_key("foo"));
+            // Unknown designations yield an empty iterator
+            let none = db
+                .iter_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Nope", None)
+                .count();
+            assert_eq!(none, 0);
+            let none = db
+                .iter_metadata_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Nope", None)
+                .count();
+            assert_eq!(none, 0);
+        }
+
+        #[test]
+        fn bb_search_unknown_designation_empty() {
+            let db = RTreeDatabase::new(None, None).unwrap();
+            let result =
+                db.get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Nope", None);
+            pretty_assertions::assert_eq!(result, Ok(Vec::new()));
+        }
+
         #[test]
         fn bb_search_ok() {
             let mut db = RTreeDatabase::new(None, None).unwrap();
@@ -514,12 +2300,212 @@ mod test {
 
             let recovered = RTreeDatabase::from_path(&tempfile.filepath).unwrap();
             pretty_assertions::assert_eq!(db.designations, recovered.designations);
-            let db_md = db.rtree.iter().collect::<Vec<&MetadataClone>>();
-            let recovered_md = recovered.rtree.iter().collect::<Vec<&MetadataClone>>();
+            let db_md = all_metadata(&db);
+            let recovered_md = all_metadata(&recovered);
+            assert_eq!(db_md.len(), recovered_md.len());
+            for element in db_md.iter() {
+                assert!(recovered_md.contains(element));
+            }
+        }
+
+        #[test]
+        fn snapshot_round_trip_ok() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            db.insert_spec_text("Foo", "foo: u8, bar: f32").unwrap();
+            db.insert_spec_text("Bar", "baz: u32").unwrap();
+            db.insert_metadata_owned(
+                0.0,
+                1.0,
+                0.0,
+                1.0,
+                0.0,
+                1.0,
+                0.0,
+                1.0,
+                "Foo",
+                vec![100, 0, 0, 128, 63],
+            )
+            .unwrap();
+            db.insert_metadata_owned(
+                2.0,
+                3.0,
+                2.0,
+                3.0,
+                2.0,
+                3.0,
+                2.0,
+                3.0,
+                "Bar",
+                vec![7, 0, 0, 0],
+            )
+            .unwrap();
+
+            let tempfile = TempFile::from("temp.snap").unwrap();
+            db.save_snapshot(&tempfile.filepath).unwrap();
+
+            let recovered = RTreeDatabase::from_snapshot(&tempfile.filepath).unwrap();
+            pretty_assertions::assert_eq!(db.designations, recovered.designations);
+            let db_md = all_metadata(&db);
+            let recovered_md = all_metadata(&recovered);
             assert_eq!(db_md.len(), recovered_md.len());
             for element in db_md.iter() {
                 assert!(recovered_md.contains(element));
             }
         }
+
+        #[test]
+        fn from_path_detects_snapshot() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            db.insert_spec_text("Foo", "foo: u8").unwrap();
+            db.insert_metadata_owned(
+                0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", vec![42],
+            )
+            .unwrap();
+
+            let tempfile = TempFile::from("temp.snap").unwrap();
+            db.save_snapshot(&tempfile.filepath).unwrap();
+
+            let recovered = RTreeDatabase::from_path(&tempfile.filepath).unwrap();
+            assert_eq!(recovered.size(), 1);
+            pretty_assertions::assert_eq!(db.designations, recovered.designations);
+        }
+
+        #[test]
+        fn snapshot_truncated_err() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            db.insert_spec_text("Foo", "foo: u8").unwrap();
+            db.insert_metadata_owned(
+                0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", vec![42],
+            )
+            .unwrap();
+
+            let tempfile = TempFile::from("temp.snap").unwrap();
+            db.save_snapshot(&tempfile.filepath).unwrap();
+            let bytes = std::fs::read(&tempfile.filepath).unwrap();
+            std::fs::write(&tempfile.filepath, &bytes[..bytes.len() - 1]).unwrap();
+
+            let result = RTreeDatabase::from_snapshot(&tempfile.filepath);
+            assert!(matches!(result, Err(DatabaseError::IOError { .. })));
+        }
+
+        #[test]
+        fn nearest_metadata_ordered_by_distance() {
+            let mut db = RTreeDatabase::new(None, None).unwrap();
+            db.insert_spec_text("Foo", "foo: u8").unwrap();
+            for i in 0..5u8 {
+                let lo = f64::from(i) + 1.0;
+                db.insert_metadata_owned(
+                    lo,
+                    lo + 0.5,
+                    lo,
+                    lo + 0.5,
+                    lo,
+                    lo + 0.5,
+                    lo,
+                    lo + 0.5,
+                    "Foo",
+                    vec![i],
+                )
+                .unwrap();
+            }
+
+            let blobs = db
+                .get_nearest_metadata_blobs(0.0, 0.0, 0.0, 0.0, "Foo", 3)
+                .unwrap();
+            pretty_assertions::assert_eq!(blobs, vec![&vec![0], &vec![1], &vec![2]]);
+
+            let data = db.get_nearest_metadata(0.0, 0.0, 0.0, 0.0, "Foo", 2).unwrap();
+            assert_eq!(data.len(), 2);
+            pretty_assertions::assert_eq!(data[0].get("foo"), Some(&DataValue::Byte(0)));
+            pretty_assertions::assert_eq!(data[1].get("foo"), Some(&DataValue::Byte(1)));
+
+            let none = db
+                .get_nearest_metadata(0.0, 0.0, 0.0, 0.0, "Unknown", 2)
+                .unwrap();
+            assert!(none.is_empty());
+        }
+
+        #[test]
+        fn wal_replay_recovers_inserts() {
+            let tempfile = TempFile::from("temp.snap").unwrap();
+            {
+                let mut db = RTreeDatabase::open_wal(&tempfile.filepath).unwrap();
+                db.insert_spec_text("Foo", "foo: u8").unwrap();
+                db.insert_metadata_owned(
+                    0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", vec![42],
+                )
+                .unwrap();
+                db.insert_metadata_owned(
+                    2.0, 3.0, 2.0, 3.0, 2.0, 3.0, 2.0, 3.0, "Foo", vec![7],
+                )
+                .unwrap();
+                db.flush_wal().unwrap();
+            }
+            // No compaction ran, so everything lives in the log
+            assert!(!std::path::Path::new(&tempfile.filepath).exists());
+
+            let recovered = RTreeDatabase::open_wal(&tempfile.filepath).unwrap();
+            assert_eq!(recovered.size(), 2);
+            assert!(recovered.designations.contains_key("Foo"));
+            let _ = std::fs::remove_file(format!("{}.log", tempfile.filepath));
+        }
+
+        #[test]
+        fn wal_compaction_truncates_log() {
+            let tempfile = TempFile::from("temp.snap").unwrap();
+            let mut db = RTreeDatabase::open_wal(&tempfile.filepath).unwrap();
+            db.wal.as_mut().unwrap().compaction_threshold = 2;
+            db.insert_spec_text("Foo", "foo: u8").unwrap();
+            db.insert_metadata_owned(
+                0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", vec![42],
+            )
+            .unwrap();
+            db.insert_metadata_owned(
+                2.0, 3.0, 2.0, 3.0, 2.0, 3.0, 2.0, 3.0, "Foo", vec![7],
+            )
+            .unwrap();
+
+            // Automatic compaction folded the log into the snapshot
+            assert!(std::path::Path::new(&tempfile.filepath).exists());
+            db.compact_wal().unwrap();
+            assert_eq!(db.wal.as_ref().unwrap().pending, 0);
+            let log_len = std::fs::metadata(format!("{}.log", tempfile.filepath))
+                .unwrap()
+                .len();
+            assert_eq!(log_len, 0);
+
+            let recovered = RTreeDatabase::open_wal(&tempfile.filepath).unwrap();
+            assert_eq!(recovered.size(), 2);
+            assert!(recovered.designations.contains_key("Foo"));
+            let _ = std::fs::remove_file(format!("{}.log", tempfile.filepath));
+        }
+
+        #[test]
+        fn wal_crash_between_rename_and_truncate_does_not_duplicate() {
+            let tempfile = TempFile::from("temp.snap").unwrap();
+            let log_path = format!("{}.log", tempfile.filepath);
+            let mut db = RTreeDatabase::open_wal(&tempfile.filepath).unwrap();
+            db.insert_spec_text("Foo", "foo: u8").unwrap();
+            db.insert_metadata_owned(
+                0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", vec![42],
+            )
+            .unwrap();
+            db.flush_wal().unwrap();
+
+            // Simulate a crash after the snapshot rename but before the
+            // log truncation: compact, then restore the stale log bytes.
+            let stale_log = std::fs::read(&log_path).unwrap();
+            db.compact_wal().unwrap();
+            drop(db);
+            std::fs::write(&log_path, &stale_log).unwrap();
+
+            let recovered = RTreeDatabase::open_wal(&tempfile.filepath).unwrap();
+            assert_eq!(recovered.size(), 1);
+            assert_eq!(
+                all_metadata(&recovered),
+                vec![([0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0], vec![42])],
+            );
+            let _ = std::fs::remove_file(log_path);
+        }
     }
 }
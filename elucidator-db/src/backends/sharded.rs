@@ -0,0 +1,500 @@
+use crate::{
+    backends::rtree::RTreeDatabase,
+    database::{Database, DatabaseConfig, Datum, Metadata, Result},
+    error::DatabaseError,
+};
+
+use elucidator::designation::{CompiledInterpreter, DesignationSpecification};
+
+use rayon::prelude::*;
+use serde::{Deserialize, Serialize};
+
+use std::collections::HashMap;
+use std::fs::File;
+use std::io::{Read, Write};
+use std::sync::RwLock;
+
+/// Current manifest format version.
+const MANIFEST_VERSION: u32 = 1;
+
+/// On-disk description of a sharded database: a small JSON manifest
+/// pointing at one file per shard, each a plain `RTreeDatabase` save.
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+struct ShardManifest {
+    elucidator_shards: u32,
+    /// Time values splitting the shards; shard `i` covers
+    /// `[boundaries[i - 1], boundaries[i])`, unbounded at the ends.
+    boundaries: Vec<f64>,
+    /// File backing each shard, in shard order.
+    paths: Vec<String>,
+    /// Designation and spec text pairs, replayed into lazily opened
+    /// shards.
+    specs: Vec<(String, String)>,
+}
+
+/// One partition: the time range it covers, the file backing it, and the
+/// lazily opened database. The lock is per shard, so a slow open on one
+/// remote mount never stalls queries against the others.
+#[derive(Debug)]
+struct Shard {
+    /// Inclusive start of the covered time range.
+    start: f64,
+    /// Exclusive end of the covered time range.
+    end: f64,
+    /// File backing this shard; `None` for shards never saved.
+    path: Option<String>,
+    db: RwLock<Option<RTreeDatabase>>,
+}
+
+impl Shard {
+    fn overlaps(&self, tmin: f64, tmax: f64) -> bool {
+        self.start <= tmax && tmin < self.end
+    }
+    /// Open the shard if it is not yet loaded, replaying the registered
+    /// specs into a fresh database when there is no backing file.
+    fn ensure_open(&self, specs: &[(String, String)]) -> Result<()> {
+        if self.db.read()?.is_some() {
+            return Ok(());
+        }
+        let mut guard = self.db.write()?;
+        if guard.is_some() {
+            return Ok(());
+        }
+        let db = match &self.path {
+            Some(path) if std::path::Path::new(path).exists() => RTreeDatabase::from_path(path)?,
+            _ => {
+                let mut db = RTreeDatabase::new(None, None)?;
+                for (designation, spec) in specs {
+                    db.insert_spec_text(designation, spec)?;
+                }
+                db
+            }
+        };
+        *guard = Some(db);
+        Ok(())
+    }
+}
+
+/// A `Database` partitioned over time-ranged shards, each an
+/// `RTreeDatabase` backed by its own file. Inserts route to the shard
+/// covering the datum's `tmin`; bounding-box queries fan out to the
+/// overlapping shards in parallel and merge the results. Shards open
+/// lazily on first touch, so a database spanning many files (possibly on
+/// remote mounts) pays only for the partitions a workload reaches.
+#[derive(Debug)]
+pub struct ShardedDatabase {
+    shards: Vec<Shard>,
+    /// Designation and spec text pairs, mirrored into every shard.
+    specs: Vec<(String, String)>,
+    /// Compiled interpreter for each designation's spec, used when
+    /// results merged from several shards need interpreting.
+    interpreters: HashMap<String, CompiledInterpreter>,
+}
+
+impl ShardedDatabase {
+    /// Create a database split at the given time boundaries: `n`
+    /// boundaries produce `n + 1` shards, unbounded at the ends.
+    /// Boundaries must be strictly increasing.
+    pub fn with_time_boundaries(boundaries: &[f64]) -> Result<Self> {
+        if boundaries.windows(2).any(|w| w[0] >= w[1]) {
+            Err(DatabaseError::ConfigError {
+                reason: "Shard boundaries must be strictly increasing".to_string(),
+            })?
+        }
+        let mut edges = vec![f64::NEG_INFINITY];
+        edges.extend_from_slice(boundaries);
+        edges.push(f64::INFINITY);
+        let shards = edges
+            .windows(2)
+            .map(|w| Shard {
+                start: w[0],
+                end: w[1],
+                path: None,
+                db: RwLock::new(None),
+            })
+            .collect();
+        Ok(ShardedDatabase {
+            shards,
+            specs: Vec::new(),
+            interpreters: HashMap::new(),
+        })
+    }
+    /// Index of the shard covering time `t`.
+    fn shard_for(&self, t: f64) -> usize {
+        self.shards
+            .iter()
+            .position(|s| s.start <= t && t < s.end)
+            .unwrap_or(self.shards.len() - 1)
+    }
+    /// The shards overlapping a queried time range, opened if needed.
+    fn overlapping(&self, tmin: f64, tmax: f64) -> Result<Vec<&Shard>> {
+        let shards: Vec<&Shard> = self
+            .shards
+            .iter()
+            .filter(|s| s.overlaps(tmin, tmax))
+            .collect();
+        for shard in &shards {
+            shard.ensure_open(&self.specs)?;
+        }
+        Ok(shards)
+    }
+    /// File backing shard `i` of a database saved at `filename`.
+    fn shard_path(filename: &str, i: usize) -> String {
+        format!("{filename}.shard{i}")
+    }
+}
+
+impl Database for ShardedDatabase {
+    /// A single unbounded shard; partition with `with_time_boundaries`.
+    fn new(_: Option<&str>, _: Option<&DatabaseConfig>) -> Result<Self> {
+        Self::with_time_boundaries(&[])
+    }
+    fn from_path(filename: &str) -> Result<Self> {
+        let mut contents = String::new();
+        File::open(filename)?.read_to_string(&mut contents)?;
+        let manifest: ShardManifest =
+            serde_json::from_str(&contents).map_err(|e| DatabaseError::ConfigError {
+                reason: format!("Cannot parse shard manifest {filename}: {e}"),
+            })?;
+        if manifest.elucidator_shards != MANIFEST_VERSION {
+            Err(DatabaseError::VersionError {
+                reason: format!(
+                    "Shard manifest version {} is not supported",
+                    manifest.elucidator_shards
+                ),
+            })?
+        }
+        let mut db = Self::with_time_boundaries(&manifest.boundaries)?;
+        if manifest.paths.len() != db.shards.len() {
+            Err(DatabaseError::ConfigError {
+                reason: format!(
+                    "Shard manifest lists {} paths for {} shards",
+                    manifest.paths.len(),
+                    db.shards.len()
+                ),
+            })?
+        }
+        for (shard, path) in db.shards.iter_mut().zip(manifest.paths) {
+            shard.path = Some(path);
+        }
+        for (designation, spec) in &manifest.specs {
+            let compiled = DesignationSpecification::from_text_cached(spec)?.compile();
+            db.interpreters.insert(designation.clone(), compiled);
+        }
+        db.specs = manifest.specs;
+        Ok(db)
+    }
+    /// Write one file per shard next to the manifest. Every shard is
+    /// opened and saved, including ones the workload never touched.
+    fn save_as(&self, filename: &str) -> Result<()> {
+        let mut paths = Vec::with_capacity(self.shards.len());
+        for (i, shard) in self.shards.iter().enumerate() {
+            let path = Self::shard_path(filename, i);
+            shard.ensure_open(&self.specs)?;
+            shard.db.read()?.as_ref().unwrap().save_as(&path)?;
+            paths.push(path);
+        }
+        let manifest = ShardManifest {
+            elucidator_shards: MANIFEST_VERSION,
+            boundaries: self
+                .shards
+                .iter()
+                .skip(1)
+                .map(|s| s.start)
+                .collect(),
+            paths,
+            specs: self.specs.clone(),
+        };
+        let mut file = File::create(filename)?;
+        write!(file, "{}", serde_json::to_string(&manifest).unwrap())?;
+        Ok(())
+    }
+    fn insert_spec_text(&mut self, designation: &str, spec: &str) -> Result<()> {
+        let compiled = DesignationSpecification::from_text_cached(spec)?.compile();
+        self.interpreters.insert(designation.to_string(), compiled);
+        self.specs
+            .push((designation.to_string(), spec.to_string()));
+        for shard in &self.shards {
+            let mut guard = shard.db.write()?;
+            if let Some(db) = guard.as_mut() {
+                db.insert_spec_text(designation, spec)?;
+            }
+        }
+        Ok(())
+    }
+    fn insert_metadata(&mut self, datum: &Metadata) -> Result<()> {
+        let shard = &self.shards[self.shard_for(datum.tmin)];
+        shard.ensure_open(&self.specs)?;
+        shard
+            .db
+            .write()?
+            .as_mut()
+            .unwrap()
+            .insert_metadata(datum)
+    }
+    fn insert_n_metadata(&mut self, data: &[Metadata]) -> Result<()> {
+        let mut groups: Vec<Vec<&Metadata>> = vec![Vec::new(); self.shards.len()];
+        for datum in data {
+            groups[self.shard_for(datum.tmin)].push(datum);
+        }
+        for (shard, group) in self.shards.iter().zip(groups) {
+            if group.is_empty() {
+                continue;
+            }
+            shard.ensure_open(&self.specs)?;
+            let batch: Vec<Metadata> = group.into_iter().cloned().collect();
+            shard
+                .db
+                .write()?
+                .as_mut()
+                .unwrap()
+                .insert_n_metadata(&batch)?;
+        }
+        Ok(())
+    }
+    fn get_metadata_in_bb(
+        &self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        epsilon: Option<f64>,
+    ) -> Result<Vec<Datum>> {
+        let blobs = self.get_metadata_blobs_in_bb(
+            xmin,
+            xmax,
+            ymin,
+            ymax,
+            zmin,
+            zmax,
+            tmin,
+            tmax,
+            designation,
+            epsilon,
+        )?;
+        let interpreter = self.interpreter(designation)?;
+        Ok(blobs
+            .par_iter()
+            .map(|b| interpreter.interpret_enum(b).unwrap())
+            .collect())
+    }
+    fn get_nearest_metadata(
+        &self,
+        x: f64,
+        y: f64,
+        z: f64,
+        t: f64,
+        designation: &str,
+        k: usize,
+    ) -> Result<Vec<Datum>> {
+        let shards = self.overlapping(f64::NEG_INFINITY, f64::INFINITY)?;
+        // Take k from every shard with distances, then keep the k
+        // globally closest.
+        let mut candidates: Vec<(f64, Vec<u8>)> = Vec::new();
+        for shard in shards {
+            let guard = shard.db.read()?;
+            let db = guard.as_ref().unwrap();
+            for (d2, blob) in
+                db.get_nearest_metadata_blobs_with_distance(x, y, z, t, designation, k)?
+            {
+                candidates.push((d2, blob.clone()));
+            }
+        }
+        candidates.sort_by(|a, b| a.0.total_cmp(&b.0));
+        candidates.truncate(k);
+        if candidates.is_empty() {
+            return Ok(Vec::new());
+        }
+        let interpreter = self.interpreter(designation)?;
+        Ok(candidates
+            .iter()
+            .map(|(_, b)| interpreter.interpret_enum(b).unwrap())
+            .collect())
+    }
+    fn get_metadata_blobs_in_bb(
+        &self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        epsilon: Option<f64>,
+    ) -> Result<Vec<Vec<u8>>> {
+        let eps = epsilon.unwrap_or(0.0);
+        let shards = self.overlapping(tmin - eps, tmax + eps)?;
+        let merged: Vec<Vec<Vec<u8>>> = shards
+            .par_iter()
+            .map(|shard| {
+                shard
+                    .db
+                    .read()?
+                    .as_ref()
+                    .unwrap()
+                    .get_metadata_blobs_in_bb(
+                        xmin,
+                        xmax,
+                        ymin,
+                        ymax,
+                        zmin,
+                        zmax,
+                        tmin,
+                        tmax,
+                        designation,
+                        epsilon,
+                    )
+            })
+            .collect::<Result<_>>()?;
+        Ok(merged.into_iter().flatten().collect())
+    }
+}
+
+impl ShardedDatabase {
+    fn interpreter(&self, designation: &str) -> Result<&CompiledInterpreter> {
+        self.interpreters
+            .get(designation)
+            .ok_or_else(|| DatabaseError::ConfigError {
+                reason: format!("No spec registered for designation {designation}"),
+            })
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    struct TempFile {
+        pub filepath: String,
+    }
+
+    impl TempFile {
+        pub fn from(filename: &str) -> Result<Self> {
+            let temp_dir = std::env::temp_dir();
+            let file_dir = temp_dir.join(format!("elucidator-shard-{}", rand::random::<u64>()));
+            let filepath = file_dir.join(filename);
+            let filepath = filepath.to_str().unwrap();
+            let _ = std::fs::create_dir_all(file_dir);
+            Ok(TempFile {
+                filepath: filepath.to_string(),
+            })
+        }
+    }
+
+    impl std::ops::Drop for TempFile {
+        fn drop(&mut self) {
+            let _ = std::fs::remove_file(&self.filepath);
+            for i in 0..16 {
+                let _ = std::fs::remove_file(ShardedDatabase::shard_path(&self.filepath, i));
+            }
+        }
+    }
+
+    fn spec_db() -> ShardedDatabase {
+        let mut db = ShardedDatabase::with_time_boundaries(&[10.0, 20.0]).unwrap();
+        db.insert_spec_text("Foo", "foo: u8").unwrap();
+        db
+    }
+
+    fn unit_metadata(t: f64, buffer: &[u8]) -> Metadata {
+        Metadata {
+            xmin: 0.0,
+            xmax: 1.0,
+            ymin: 0.0,
+            ymax: 1.0,
+            zmin: 0.0,
+            zmax: 1.0,
+            tmin: t,
+            tmax: t + 0.5,
+            designation: "Foo",
+            buffer,
+        }
+    }
+
+    #[test]
+    fn increasing_boundaries_required() {
+        let result = ShardedDatabase::with_time_boundaries(&[5.0, 5.0]);
+        assert!(matches!(
+            result,
+            Err(DatabaseError::ConfigError { .. })
+        ));
+    }
+
+    #[test]
+    fn inserts_route_to_time_shards() {
+        let mut db = spec_db();
+        db.insert_metadata(&unit_metadata(5.0, &[1])).unwrap();
+        db.insert_metadata(&unit_metadata(15.0, &[2])).unwrap();
+        db.insert_metadata(&unit_metadata(25.0, &[3])).unwrap();
+
+        let middle = db
+            .get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 12.0, 18.0, "Foo", None)
+            .unwrap();
+        let all = db
+            .get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 30.0, "Foo", None)
+            .unwrap();
+
+        pretty_assertions::assert_eq!(middle, vec![vec![2]]);
+        assert_eq!(all.len(), 3);
+    }
+
+    #[test]
+    fn batch_insert_splits_across_shards() {
+        let mut db = spec_db();
+        let buffers: Vec<[u8; 1]> = (0..30u8).map(|i| [i]).collect();
+        let data: Vec<Metadata> = buffers
+            .iter()
+            .enumerate()
+            .map(|(i, b)| unit_metadata(i as f64, b))
+            .collect();
+        db.insert_n_metadata(&data).unwrap();
+
+        let result = db
+            .get_metadata_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 30.0, "Foo", None)
+            .unwrap();
+        assert_eq!(result.len(), 30);
+    }
+
+    #[test]
+    fn nearest_merges_across_shards() {
+        let mut db = spec_db();
+        db.insert_metadata(&unit_metadata(9.0, &[1])).unwrap();
+        db.insert_metadata(&unit_metadata(11.0, &[2])).unwrap();
+        db.insert_metadata(&unit_metadata(25.0, &[3])).unwrap();
+
+        let result = db.get_nearest_metadata(0.5, 0.5, 0.5, 10.0, "Foo", 2).unwrap();
+
+        assert_eq!(result.len(), 2);
+    }
+
+    #[test]
+    fn save_and_reload_round_trips() {
+        let tempfile = TempFile::from("shards.json").unwrap();
+        let mut db = spec_db();
+        db.insert_metadata(&unit_metadata(5.0, &[1])).unwrap();
+        db.insert_metadata(&unit_metadata(25.0, &[3])).unwrap();
+        db.save_as(&tempfile.filepath).unwrap();
+
+        let reloaded = ShardedDatabase::from_path(&tempfile.filepath).unwrap();
+        let all = reloaded
+            .get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 30.0, "Foo", None)
+            .unwrap();
+
+        assert_eq!(all.len(), 2);
+        // Only the overlapping shard should have been opened by a
+        // narrower query against a fresh load.
+        let lazy = ShardedDatabase::from_path(&tempfile.filepath).unwrap();
+        let early = lazy
+            .get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 6.0, "Foo", None)
+            .unwrap();
+        pretty_assertions::assert_eq!(early, vec![vec![1]]);
+        assert!(lazy.shards[2].db.read().unwrap().is_none());
+    }
+}
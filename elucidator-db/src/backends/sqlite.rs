@@ -14,15 +14,96 @@ use serde_json;
 
 use std::fs::File;
 use std::io::Write;
-use std::sync::{Arc, Mutex};
+use std::sync::{
+    mpsc::{Receiver, SyncSender},
+    Arc, Mutex,
+};
 
 pub struct SqlDatabase {
     /// Active database connection
     conn: Arc<Mutex<Connection>>,
     /// Mapping of designations
-    designations: HashMap<String, DesignationSpecification>,
+    designations: HashMap<String, Arc<DesignationSpecification>>,
     /// Extra configuration settings for the database
     config: SqliteConfig,
+    /// Blob compression machinery, present only in compress mode
+    compression: Option<Mutex<CompressionState>>,
+}
+
+/// Stored blob layout in compress mode: a one-byte tag, the original
+/// length as a little-endian u32, then the zstd frame.
+const COMPRESS_PLAIN_TAG: u8 = 1;
+const COMPRESS_DICT_TAG: u8 = 2;
+/// Blobs of one designation sampled before its dictionary is trained.
+const COMPRESS_TRAIN_SAMPLES: usize = 64;
+const COMPRESS_DICT_CAPACITY: usize = 16 * 1024;
+const COMPRESS_LEVEL: i32 = 3;
+
+/// Rows per chunk shipped from the fetch thread during streaming loads.
+pub(crate) const STREAM_CHUNK_ROWS: usize = 8192;
+/// Chunks allowed in flight between the fetch thread and the decoders
+/// before fetching blocks.
+const STREAM_CHUNK_BACKLOG: usize = 4;
+
+/// One row of the metadata join with its buffer exactly as stored, before
+/// any decoding. Streaming loads ship these so decoding (including
+/// decompression in compress mode) can run on worker threads while the
+/// next chunk is fetched; pair with the decoders from `raw_decoders`.
+#[derive(Debug)]
+pub(crate) struct RawMetadataRow {
+    pub xmin: f64,
+    pub xmax: f64,
+    pub ymin: f64,
+    pub ymax: f64,
+    pub zmin: f64,
+    pub zmax: f64,
+    pub tmin: f64,
+    pub tmax: f64,
+    pub designation: String,
+    pub stored: Vec<u8>,
+}
+
+/// Per-designation dictionaries and the samples gathered to train them.
+/// An empty dictionary marks a designation whose training failed, so its
+/// blobs stay dictionary-less rather than retrying forever.
+#[derive(Debug, Default)]
+struct CompressionState {
+    dicts: HashMap<String, Vec<u8>>,
+    samples: HashMap<String, Vec<Vec<u8>>>,
+}
+
+/// Snapshot of one designation's dictionary, taken once per query so row
+/// loops decompress without touching the shared state.
+#[derive(Debug, Clone)]
+pub(crate) struct BlobDecoder {
+    dict: Option<Vec<u8>>,
+}
+
+impl BlobDecoder {
+    pub(crate) fn decode(&self, stored: &[u8]) -> Result<Vec<u8>> {
+        if stored.len() < 5 {
+            Err(DatabaseError::IOError {
+                reason: "Compressed blob shorter than its header".to_string(),
+            })?;
+        }
+        let tag = stored[0];
+        let raw_len = u32::from_le_bytes(stored[1..5].try_into().unwrap()) as usize;
+        let frame = &stored[5..];
+        let buffer = match tag {
+            COMPRESS_PLAIN_TAG => zstd::bulk::Decompressor::new()?.decompress(frame, raw_len)?,
+            COMPRESS_DICT_TAG => match &self.dict {
+                Some(dict) => zstd::bulk::Decompressor::with_dictionary(dict)?
+                    .decompress(frame, raw_len)?,
+                None => Err(DatabaseError::IOError {
+                    reason: "Blob needs a dictionary the database does not hold".to_string(),
+                })?,
+            },
+            _ => Err(DatabaseError::IOError {
+                reason: format!("Unknown compression tag {tag}"),
+            })?,
+        };
+        Ok(buffer)
+    }
 }
 
 #[derive(Clone, PartialEq, Debug, Serialize, Deserialize)]
@@ -34,6 +115,8 @@ pub struct SqliteConfig {
     use_memory_temp_store: bool,
     threads: u32,
     cached_pages: u32,
+    #[serde(default)]
+    compress: bool,
 }
 
 impl Config for SqliteConfig {
@@ -46,6 +129,7 @@ impl Config for SqliteConfig {
             use_memory_temp_store: false,
             threads: 0,
             cached_pages: 0,
+            compress: false,
         }
     }
     fn from_json_file(filename: &str) -> Result<Self> {
@@ -75,6 +159,11 @@ impl SqliteConfig {
         self.synchronous_off = true;
         self.clone()
     }
+    /// Compress blobs on insert with per-designation zstd dictionaries.
+    pub fn compress(&mut self) -> Self {
+        self.compress = true;
+        self.clone()
+    }
 }
 
 impl SqlDatabase {
@@ -123,6 +212,23 @@ impl SqlDatabase {
             )",
             [],
         )?;
+        // Deliberately no index on Metadata: the R*Tree virtual table
+        // above is the spatial index, and containment queries must drive
+        // from it with rowid lookups into Metadata. A covering index on
+        // (designation, buffer) flips the planner into scanning it and
+        // probing the R-tree per row — orders of magnitude slower on
+        // selective boxes — while duplicating every blob on disk, and an
+        // index on designation alone goes unused in favor of the same
+        // R-tree-driven plan.
+        if self.config.compress {
+            conn.execute(
+                "CREATE TABLE CompressionDictionaries (
+                    designation TEXT NOT NULL PRIMARY KEY,
+                    dict BLOB NOT NULL
+                )",
+                [],
+            )?;
+        }
         conn.execute("PRAGMA optimize", [])?;
         Ok(())
     }
@@ -153,11 +259,67 @@ impl SqlDatabase {
         }
         Ok(())
     }
-    pub fn get_designations(&self) -> HashMap<String, DesignationSpecification> {
+    pub fn get_designations(&self) -> HashMap<String, Arc<DesignationSpecification>> {
         self.designations.clone()
     }
+    /// Compress one insert payload, training the designation's dictionary
+    /// once enough samples accumulate. Returns the stored bytes plus a
+    /// freshly trained dictionary to persist, if training just happened.
+    fn encode_buffer(
+        &self,
+        designation: &str,
+        buffer: &[u8],
+    ) -> Result<(Vec<u8>, Option<Vec<u8>>)> {
+        let state_lock = self
+            .compression
+            .as_ref()
+            .expect("encode_buffer requires compress mode");
+        let mut state = state_lock.lock()?;
+        let mut new_dict = None;
+        if !state.dicts.contains_key(designation) {
+            let samples = state.samples.entry(designation.to_string()).or_default();
+            samples.push(buffer.to_vec());
+            if samples.len() >= COMPRESS_TRAIN_SAMPLES {
+                let samples = state.samples.remove(designation).unwrap();
+                let dict =
+                    zstd::dict::from_samples(&samples, COMPRESS_DICT_CAPACITY).unwrap_or_default();
+                if !dict.is_empty() {
+                    new_dict = Some(dict.clone());
+                }
+                state.dicts.insert(designation.to_string(), dict);
+            }
+        }
+        let dict = state.dicts.get(designation).filter(|d| !d.is_empty());
+        let (tag, frame) = match dict {
+            Some(dict) => (
+                COMPRESS_DICT_TAG,
+                zstd::bulk::Compressor::with_dictionary(COMPRESS_LEVEL, dict)?.compress(buffer)?,
+            ),
+            None => (COMPRESS_PLAIN_TAG, zstd::bulk::compress(buffer, COMPRESS_LEVEL)?),
+        };
+        let mut stored = Vec::with_capacity(5 + frame.len());
+        stored.push(tag);
+        stored.extend((buffer.len() as u32).to_le_bytes());
+        stored.extend(frame);
+        Ok((stored, new_dict))
+    }
+    /// Per-query decoder: `None` outside compress mode, otherwise a
+    /// snapshot of the designation's dictionary.
+    fn blob_decoder(&self, designation: &str) -> Result<Option<BlobDecoder>> {
+        let Some(state_lock) = &self.compression else {
+            return Ok(None);
+        };
+        let state = state_lock.lock()?;
+        let dict = state
+            .dicts
+            .get(designation)
+            .filter(|d| !d.is_empty())
+            .cloned();
+        Ok(Some(BlobDecoder { dict }))
+    }
     pub fn get_all_metadata(&self) -> Result<Vec<MetadataClone>> {
         let mut data = Vec::new();
+        let mut decoders: HashMap<String, Result<Option<BlobDecoder>>> = HashMap::new();
         let conn = self.conn.lock()?;
         let mut stmt = conn.prepare_cached(
             "SELECT 
@@ -182,10 +344,18 @@ impl SqlDatabase {
             let tmin = row.get_ref(7)?.as_f64()?;
             let tmax = row.get_ref(8)?.as_f64()?;
             let designation = row.get_ref(9)?.as_str()?;
-            let buffer = match row.get_ref(10)? {
+            let stored = match row.get_ref(10)? {
                 rusqlite::types::ValueRef::Blob(b) => b,
                 _ => unreachable!("We should always retrieve blobs!"),
             };
+            let buffer = match decoders
+                .entry(designation.to_string())
+                .or_insert_with(|| self.blob_decoder(designation))
+            {
+                Ok(Some(decoder)) => decoder.decode(stored)?,
+                Ok(None) => stored.to_vec(),
+                Err(e) => Err(e.clone())?,
+            };
             data.push(MetadataClone {
                 xmin,
                 xmax,
@@ -195,12 +365,87 @@ impl SqlDatabase {
                 zmax,
                 tmin,
                 tmax,
-                designation: designation.to_string(),
-                buffer: buffer.into(),
+                designation: designation.into(),
+                buffer,
             });
         }
         Ok(data)
     }
+    /// Stream every metadata row in chunks of `STREAM_CHUNK_ROWS` from a
+    /// dedicated fetch thread, undecoded. The channel closes after the
+    /// final chunk; if fetching fails, the error arrives as the last item.
+    pub(crate) fn stream_raw_metadata(&self) -> Receiver<Result<Vec<RawMetadataRow>>> {
+        let (tx, rx) = std::sync::mpsc::sync_channel(STREAM_CHUNK_BACKLOG);
+        let conn = Arc::clone(&self.conn);
+        std::thread::spawn(move || {
+            if let Err(e) = Self::fetch_raw_chunks(&conn, &tx) {
+                let _ = tx.send(Err(e));
+            }
+        });
+        rx
+    }
+    /// Decoder snapshot for every designation, for decoding raw rows off
+    /// the fetch thread. `None` means the designation's blobs are stored
+    /// as-is.
+    pub(crate) fn raw_decoders(&self) -> Result<HashMap<String, Option<BlobDecoder>>> {
+        self.designations
+            .keys()
+            .map(|d| Ok((d.clone(), self.blob_decoder(d)?)))
+            .collect()
+    }
+    fn fetch_raw_chunks(
+        conn: &Mutex<Connection>,
+        tx: &SyncSender<Result<Vec<RawMetadataRow>>>,
+    ) -> Result<()> {
+        let conn = conn.lock()?;
+        let mut stmt = conn.prepare_cached(
+            "SELECT
+                ml.id, ml.xmin, ml.xmax, ml.ymin, ml.ymax, ml.zmin, ml.zmax, ml.tmin, ml.tmax,
+                m.designation, m.buffer
+            FROM
+                Metadata AS m
+            JOIN
+                MetadataLocations AS ml
+            ON
+                ml.id = m.id
+            ",
+        )?;
+        let mut rows = stmt.raw_query();
+        let mut chunk = Vec::with_capacity(STREAM_CHUNK_ROWS);
+        while let Some(row) = rows.next()? {
+            let stored = match row.get_ref(10)? {
+                rusqlite::types::ValueRef::Blob(b) => b.to_vec(),
+                _ => unreachable!("We should always retrieve blobs!"),
+            };
+            chunk.push(RawMetadataRow {
+                xmin: row.get_ref(1)?.as_f64()?,
+                xmax: row.get_ref(2)?.as_f64()?,
+                ymin: row.get_ref(3)?.as_f64()?,
+                ymax: row.get_ref(4)?.as_f64()?,
+                zmin: row.get_ref(5)?.as_f64()?,
+                zmax: row.get_ref(6)?.as_f64()?,
+                tmin: row.get_ref(7)?.as_f64()?,
+                tmax: row.get_ref(8)?.as_f64()?,
+                designation: row.get_ref(9)?.as_str()?.to_string(),
+                stored,
+            });
+            if chunk.len() >= STREAM_CHUNK_ROWS
+                && tx
+                    .send(Ok(std::mem::replace(
+                        &mut chunk,
+                        Vec::with_capacity(STREAM_CHUNK_ROWS),
+                    )))
+                    .is_err()
+            {
+                // The receiver hung up; stop fetching.
+                return Ok(());
+            }
+        }
+        if !chunk.is_empty() {
+            let _ = tx.send(Ok(chunk));
+        }
+        Ok(())
+    }
 }
 
 impl Database for SqlDatabase {
@@ -214,17 +459,22 @@ impl Database for SqlDatabase {
             },
             None => SqliteConfig::new(),
         };
+        let compression = config
+            .compress
+            .then(|| Mutex::new(CompressionState::default()));
         let db = if let Some(name) = filename {
             SqlDatabase {
                 conn: Arc::new(Mutex::new(Connection::open(name)?)),
                 designations: HashMap::new(),
                 config,
+                compression,
             }
         } else {
             SqlDatabase {
                 conn: Arc::new(Mutex::new(Connection::open_in_memory()?)),
                 designations: HashMap::new(),
                 config,
+                compression,
             }
         };
         db.initialize()?;
@@ -240,14 +490,41 @@ impl Database for SqlDatabase {
             while let Some(row) = rows.next()? {
                 let designation: String = row.get(0)?;
                 let spec_text: String = row.get(1)?;
-                let spec = DesignationSpecification::from_text(&spec_text).unwrap();
+                let spec = DesignationSpecification::from_text_cached(&spec_text).unwrap();
                 designations.insert(designation, spec);
             }
         }
+        // The dictionary table marks a database written in compress mode;
+        // reload its dictionaries so stored blobs stay decodable.
+        let compressed: bool = conn.query_row(
+            "SELECT COUNT(*) FROM sqlite_master
+             WHERE type = 'table' AND name = 'CompressionDictionaries'",
+            [],
+            |row| row.get::<usize, i64>(0),
+        )? > 0;
+        let mut config = SqliteConfig::new();
+        let compression = if compressed {
+            config.compress = true;
+            let mut state = CompressionState::default();
+            let mut stmt =
+                conn.prepare_cached("SELECT designation, dict FROM CompressionDictionaries;")?;
+            let mut rows = stmt.query([])?;
+            while let Some(row) = rows.next()? {
+                let designation: String = row.get(0)?;
+                let dict: Vec<u8> = row.get(1)?;
+                state.dicts.insert(designation, dict);
+            }
+            drop(rows);
+            drop(stmt);
+            Some(Mutex::new(state))
+        } else {
+            None
+        };
         Ok(SqlDatabase {
             conn: Arc::new(Mutex::new(conn)),
             designations,
-            config: SqliteConfig::new(),
+            config,
+            compression,
         })
     }
     fn save_as(&self, filename: &str) -> Result<()> {
@@ -257,7 +534,7 @@ impl Database for SqlDatabase {
     }
 
     fn insert_spec_text(&mut self, designation: &str, spec: &str) -> Result<()> {
-        let designation_spec = DesignationSpecification::from_text(spec)?;
+        let designation_spec = DesignationSpecification::from_text_cached(spec)?;
         let conn = self.conn.lock()?;
         conn.execute(
             "INSERT INTO designation_spec (designation, spec) VALUES (?1, ?2)",
@@ -268,6 +545,11 @@ impl Database for SqlDatabase {
         Ok(())
     }
     fn insert_metadata(&mut self, datum: &Metadata) -> Result<()> {
+        let encoded = if self.compression.is_some() {
+            Some(self.encode_buffer(datum.designation, datum.buffer)?)
+        } else {
+            None
+        };
         let mut conn = self.conn.lock()?;
         let tx = conn.transaction()?;
         {
@@ -282,19 +564,37 @@ impl Database for SqlDatabase {
                 "INSERT INTO Metadata (id, designation, buffer) VALUES (last_insert_rowid(), ?1, ?2)",
             )?;
             stmt.raw_bind_parameter(1, datum.designation)?;
-            stmt.raw_bind_parameter(2, datum.buffer)?;
+            match &encoded {
+                Some((stored, _)) => stmt.raw_bind_parameter(2, stored.as_slice())?,
+                None => stmt.raw_bind_parameter(2, datum.buffer)?,
+            }
             stmt.raw_execute()?;
         }
+        if let Some((_, Some(dict))) = &encoded {
+            tx.execute(
+                "INSERT OR REPLACE INTO CompressionDictionaries (designation, dict) VALUES (?1, ?2)",
+                (datum.designation, dict),
+            )?;
+        }
 
         tx.commit()?;
 
         Ok(())
     }
     fn insert_n_metadata(&mut self, data: &[Metadata]) -> Result<()> {
+        let encoded = if self.compression.is_some() {
+            let mut encoded = Vec::with_capacity(data.len());
+            for datum in data {
+                encoded.push(self.encode_buffer(datum.designation, datum.buffer)?);
+            }
+            Some(encoded)
+        } else {
+            None
+        };
         let mut conn = self.conn.lock()?;
         let tx = conn.transaction()?;
 
-        for datum in data {
+        for (i, datum) in data.iter().enumerate() {
             let mut stmt = tx.prepare_cached(
                 "INSERT INTO MetadataLocations (xmin, xmax, ymin, ymax, zmin, zmax, tmin, tmax) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8)",
             )?;
@@ -306,9 +606,20 @@ impl Database for SqlDatabase {
                 "INSERT INTO Metadata (id, designation, buffer) VALUES (last_insert_rowid(), ?1, ?2)",
             )?;
             stmt.raw_bind_parameter(1, datum.designation)?;
-            stmt.raw_bind_parameter(2, datum.buffer)?;
+            match &encoded {
+                Some(encoded) => stmt.raw_bind_parameter(2, encoded[i].0.as_slice())?,
+                None => stmt.raw_bind_parameter(2, datum.buffer)?,
+            }
             stmt.raw_execute()?;
         }
+        for (i, datum) in data.iter().enumerate() {
+            if let Some(Some(dict)) = encoded.as_ref().map(|e| &e[i].1) {
+                tx.execute(
+                    "INSERT OR REPLACE INTO CompressionDictionaries (designation, dict) VALUES (?1, ?2)",
+                    (datum.designation, dict),
+                )?;
+            }
+        }
 
         tx.commit()?;
 
@@ -367,6 +678,8 @@ impl Database for SqlDatabase {
         stmt.raw_bind_parameter(8, tmax)?;
         stmt.raw_bind_parameter(9, designation)?;
 
+        let d = self.designations.get(designation).unwrap();
+        let decoder = self.blob_decoder(designation)?;
         let mut rows = stmt.raw_query();
         let mut data = Vec::new();
         while let Some(row) = rows.next()? {
@@ -374,26 +687,132 @@ impl Database for SqlDatabase {
                 rusqlite::types::ValueRef::Blob(b) => b,
                 _ => unreachable!("We should always retrieve blobs!"),
             };
-            let d = self.designations.get(designation).unwrap();
-            data.push(d.interpret_enum(buffer).unwrap());
+            match &decoder {
+                Some(decoder) => data.push(d.interpret_enum(&decoder.decode(buffer)?).unwrap()),
+                None => data.push(d.interpret_enum(buffer).unwrap()),
+            }
+        }
+        Ok(data)
+    }
+
+    fn get_nearest_metadata(
+        &self,
+        x: f64,
+        y: f64,
+        z: f64,
+        t: f64,
+        designation: &str,
+        k: usize,
+    ) -> Result<Vec<Datum>> {
+        // No spatial index on disk: rank the designation's rows by
+        // squared euclidean distance from the point to each envelope,
+        // pushing the ordering and limit into SQLite so only the k
+        // winners cross into Rust for interpretation.
+        let conn = self.conn.lock()?;
+        let mut stmt = conn.prepare_cached(
+            "SELECT 
+                m.buffer,
+                MAX(ml.xmin - ?1, ?1 - ml.xmax, 0) * MAX(ml.xmin - ?1, ?1 - ml.xmax, 0) +
+                MAX(ml.ymin - ?2, ?2 - ml.ymax, 0) * MAX(ml.ymin - ?2, ?2 - ml.ymax, 0) +
+                MAX(ml.zmin - ?3, ?3 - ml.zmax, 0) * MAX(ml.zmin - ?3, ?3 - ml.zmax, 0) +
+                MAX(ml.tmin - ?4, ?4 - ml.tmax, 0) * MAX(ml.tmin - ?4, ?4 - ml.tmax, 0)
+                AS distance_2
+            FROM 
+                Metadata AS m
+            JOIN 
+                MetadataLocations AS ml
+            ON 
+                ml.id = m.id
+            WHERE 
+                m.designation = ?5
+            ORDER BY 
+                distance_2
+            LIMIT ?6
+            ",
+        )?;
+        stmt.raw_bind_parameter(1, x)?;
+        stmt.raw_bind_parameter(2, y)?;
+        stmt.raw_bind_parameter(3, z)?;
+        stmt.raw_bind_parameter(4, t)?;
+        stmt.raw_bind_parameter(5, designation)?;
+        stmt.raw_bind_parameter(6, k as i64)?;
+
+        let d = self.designations.get(designation).unwrap();
+        let decoder = self.blob_decoder(designation)?;
+        let mut rows = stmt.raw_query();
+        let mut data = Vec::new();
+        while let Some(row) = rows.next()? {
+            let buffer = match row.get_ref(0)? {
+                rusqlite::types::ValueRef::Blob(b) => b,
+                _ => unreachable!("We should always retrieve blobs!"),
+            };
+            match &decoder {
+                Some(decoder) => data.push(d.interpret_enum(&decoder.decode(buffer)?).unwrap()),
+                None => data.push(d.interpret_enum(buffer).unwrap()),
+            }
         }
         Ok(data)
     }
 
     fn get_metadata_blobs_in_bb(
         &self,
-        _xmin: f64,
-        _xmax: f64,
-        _ymin: f64,
-        _ymax: f64,
-        _zmin: f64,
-        _zmax: f64,
-        _tmin: f64,
-        _tmax: f64,
-        _designation: &str,
-        _epsilon: Option<f64>,
-    ) -> Result<Vec<&Vec<u8>>> {
-        todo!();
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        epsilon: Option<f64>,
+    ) -> Result<Vec<Vec<u8>>> {
+        let eps = epsilon.unwrap_or(0.0);
+        let conn = self.conn.lock()?;
+        let mut stmt = conn.prepare_cached(
+            "SELECT 
+                m.buffer
+            FROM 
+                Metadata AS m
+            JOIN 
+                MetadataLocations AS ml
+            ON 
+                ml.id = m.id
+            WHERE 
+                ml.xmin >= ?1 AND ml.xmax <= ?2 AND
+                ml.ymin >= ?3 AND ml.ymax <= ?4 AND
+                ml.zmin >= ?5 AND ml.zmax <= ?6 AND
+                ml.tmin >= ?7 AND ml.tmax <= ?8 AND
+                m.designation = ?9
+            ",
+        )?;
+
+        stmt.raw_bind_parameter(1, xmin - eps)?;
+        stmt.raw_bind_parameter(2, xmax + eps)?;
+        stmt.raw_bind_parameter(3, ymin - eps)?;
+        stmt.raw_bind_parameter(4, ymax + eps)?;
+        stmt.raw_bind_parameter(5, zmin - eps)?;
+        stmt.raw_bind_parameter(6, zmax + eps)?;
+        stmt.raw_bind_parameter(7, tmin - eps)?;
+        stmt.raw_bind_parameter(8, tmax + eps)?;
+        stmt.raw_bind_parameter(9, designation)?;
+
+        // Stream rows straight out of the borrowed blob column; the only
+        // allocation per row is the returned buffer itself.
+        let decoder = self.blob_decoder(designation)?;
+        let mut rows = stmt.raw_query();
+        let mut data = Vec::new();
+        while let Some(row) = rows.next()? {
+            let buffer = match row.get_ref(0)? {
+                rusqlite::types::ValueRef::Blob(b) => b,
+                _ => unreachable!("We should always retrieve blobs!"),
+            };
+            match &decoder {
+                Some(decoder) => data.push(decoder.decode(buffer)?),
+                None => data.push(buffer.to_vec()),
+            }
+        }
+        Ok(data)
     }
 }
 
@@ -660,5 +1079,185 @@ mod test {
             ];
             pretty_assertions::assert_eq!(result, Ok(expected),);
         }
+
+        #[test]
+        fn nearest_search_ok() {
+            let mut db = SqlDatabase::new(None, None).unwrap();
+
+            let designation = "Foo";
+            let spec = "foo: u8";
+            let _ = db.insert_spec_text(designation, spec);
+            for i in 0..5u8 {
+                let lo = f64::from(i) + 1.0;
+                let buffer = &[i; 1];
+                let md = Metadata {
+                    xmin: lo,
+                    xmax: lo + 0.5,
+                    ymin: lo,
+                    ymax: lo + 0.5,
+                    zmin: lo,
+                    zmax: lo + 0.5,
+                    tmin: lo,
+                    tmax: lo + 0.5,
+                    designation,
+                    buffer,
+                };
+                let _ = db.insert_metadata(&md);
+            }
+
+            let result = db.get_nearest_metadata(0.0, 0.0, 0.0, 0.0, "Foo", 2);
+
+            let expected: Vec<HashMap<&str, DataValue>> = vec![
+                HashMap::from([("foo", DataValue::Byte(0))]),
+                HashMap::from([("foo", DataValue::Byte(1))]),
+            ];
+            pretty_assertions::assert_eq!(result, Ok(expected),);
+        }
+
+        #[test]
+        fn raw_stream_matches_get_all() {
+            let mut db = SqlDatabase::new(None, None).unwrap();
+            let _ = db.insert_spec_text("Foo", "foo: u8");
+            for i in 0..10u8 {
+                let lo = f64::from(i);
+                let md = Metadata {
+                    xmin: lo,
+                    xmax: lo + 1.0,
+                    ymin: lo,
+                    ymax: lo + 1.0,
+                    zmin: 0.0,
+                    zmax: 1.0,
+                    tmin: 0.0,
+                    tmax: 1.0,
+                    designation: "Foo",
+                    buffer: &[i],
+                };
+                let _ = db.insert_metadata(&md);
+            }
+
+            let decoders = db.raw_decoders().unwrap();
+            let mut streamed: Vec<MetadataClone> = Vec::new();
+            for chunk in db.stream_raw_metadata() {
+                for row in chunk.unwrap() {
+                    let buffer = match decoders.get(&row.designation) {
+                        Some(Some(decoder)) => decoder.decode(&row.stored).unwrap(),
+                        _ => row.stored,
+                    };
+                    streamed.push(MetadataClone {
+                        xmin: row.xmin,
+                        xmax: row.xmax,
+                        ymin: row.ymin,
+                        ymax: row.ymax,
+                        zmin: row.zmin,
+                        zmax: row.zmax,
+                        tmin: row.tmin,
+                        tmax: row.tmax,
+                        designation: row.designation.into(),
+                        buffer,
+                    });
+                }
+            }
+
+            pretty_assertions::assert_eq!(streamed, db.get_all_metadata().unwrap());
+        }
+
+        #[test]
+        fn blob_search_ok() {
+            let mut db = SqlDatabase::new(None, None).unwrap();
+
+            let designation = "Foo";
+            let spec = "foo: u8";
+            let _ = db.insert_spec_text(designation, spec);
+            let md = Metadata {
+                xmin: 0.0,
+                xmax: 1.0,
+                ymin: 0.0,
+                ymax: 1.0,
+                zmin: 0.0,
+                zmax: 1.0,
+                tmin: 0.0,
+                tmax: 1.0,
+                designation,
+                buffer: &[42],
+            };
+            let _ = db.insert_metadata(&md);
+
+            let result =
+                db.get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None);
+
+            pretty_assertions::assert_eq!(result, Ok(vec![vec![42]]),);
+        }
+
+        #[test]
+        fn compressed_roundtrip_ok() {
+            let config = DatabaseConfig::SqliteConfig(SqliteConfig::new().compress());
+            let mut db = SqlDatabase::new(None, Some(&config)).unwrap();
+
+            let designation = "Foo";
+            let spec = "foo: u32[16]";
+            let _ = db.insert_spec_text(designation, spec);
+            // Enough data to push past dictionary training
+            let buffer: Vec<u8> = (0..COMPRESS_TRAIN_SAMPLES as u32 * 2)
+                .flat_map(|i| (i % 7).to_le_bytes())
+                .take(64)
+                .collect();
+            for _ in 0..(COMPRESS_TRAIN_SAMPLES * 2) {
+                let md = Metadata {
+                    xmin: 0.0,
+                    xmax: 1.0,
+                    ymin: 0.0,
+                    ymax: 1.0,
+                    zmin: 0.0,
+                    zmax: 1.0,
+                    tmin: 0.0,
+                    tmax: 1.0,
+                    designation,
+                    buffer: &buffer,
+                };
+                db.insert_metadata(&md).unwrap();
+            }
+
+            let result = db
+                .get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None)
+                .unwrap();
+
+            assert_eq!(result.len(), COMPRESS_TRAIN_SAMPLES * 2);
+            assert!(result.iter().all(|b| b == &buffer));
+        }
+
+        #[test]
+        fn compressed_database_reloads_from_path() {
+            let tempfile = TempFile::from("temp.db").unwrap();
+            let designation = "Foo";
+            let buffer: Vec<u8> = (0..16u32).flat_map(|i| (i % 3).to_le_bytes()).collect();
+            {
+                let config = DatabaseConfig::SqliteConfig(SqliteConfig::new().compress());
+                let mut db = SqlDatabase::new(Some(&tempfile.filepath), Some(&config)).unwrap();
+                let _ = db.insert_spec_text(designation, "foo: u32[16]");
+                for _ in 0..(COMPRESS_TRAIN_SAMPLES * 2) {
+                    let md = Metadata {
+                        xmin: 0.0,
+                        xmax: 1.0,
+                        ymin: 0.0,
+                        ymax: 1.0,
+                        zmin: 0.0,
+                        zmax: 1.0,
+                        tmin: 0.0,
+                        tmax: 1.0,
+                        designation,
+                        buffer: &buffer,
+                    };
+                    db.insert_metadata(&md).unwrap();
+                }
+            }
+
+            let db = SqlDatabase::from_path(&tempfile.filepath).unwrap();
+            let result = db
+                .get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None)
+                .unwrap();
+
+            assert_eq!(result.len(), COMPRESS_TRAIN_SAMPLES * 2);
+            assert!(result.iter().all(|b| b == &buffer));
+        }
     }
 }
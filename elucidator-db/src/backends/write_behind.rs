@@ -0,0 +1,320 @@
+use crate::{
+    backends::sqlite::SqlDatabase,
+    database::{Database, Metadata, Result},
+    error::DatabaseError,
+};
+
+use std::sync::{Arc, Condvar, Mutex, RwLock};
+use std::thread::JoinHandle;
+
+/// How many inserts may sit in the queue before callers block.
+const DEFAULT_QUEUE_CAPACITY: usize = 65_536;
+
+/// Owned form of `Metadata`, so queued inserts outlive the caller's
+/// borrowed designation and buffer.
+#[derive(Debug)]
+struct QueuedInsert {
+    xmin: f64,
+    xmax: f64,
+    ymin: f64,
+    ymax: f64,
+    zmin: f64,
+    zmax: f64,
+    tmin: f64,
+    tmax: f64,
+    designation: String,
+    buffer: Vec<u8>,
+}
+
+/// Queue bookkeeping guarded by one mutex. Sequence numbers let `flush`
+/// wait for exactly the inserts enqueued before it was called.
+#[derive(Debug)]
+struct QueueState {
+    pending: Vec<QueuedInsert>,
+    enqueued: u64,
+    committed: u64,
+    shutdown: bool,
+    error: Option<DatabaseError>,
+}
+
+struct WriteBehindShared {
+    db: RwLock<SqlDatabase>,
+    state: Mutex<QueueState>,
+    /// Wakes the writer when work or shutdown is pending.
+    work: Condvar,
+    /// Wakes callers blocked on backpressure or `flush`.
+    done: Condvar,
+}
+
+/// Write-behind wrapper around `SqlDatabase`. Inserts enqueue into a
+/// bounded buffer and return immediately; a dedicated writer thread
+/// drains whatever has accumulated into one multi-row transaction per
+/// pass, so per-datum commit latency never lands on the caller. Queries
+/// pass through to the inner database and see committed data only —
+/// call `flush` first for read-your-writes. Any error the writer hits is
+/// held and surfaced by the next insert or flush.
+pub struct WriteBehind {
+    shared: Arc<WriteBehindShared>,
+    writer: Option<JoinHandle<()>>,
+}
+
+impl WriteBehind {
+    pub fn new(db: SqlDatabase) -> Self {
+        let shared = Arc::new(WriteBehindShared {
+            db: RwLock::new(db),
+            state: Mutex::new(QueueState {
+                pending: Vec::new(),
+                enqueued: 0,
+                committed: 0,
+                shutdown: false,
+                error: None,
+            }),
+            work: Condvar::new(),
+            done: Condvar::new(),
+        });
+        let writer_shared = Arc::clone(&shared);
+        let writer = std::thread::spawn(move || Self::drain_loop(&writer_shared));
+        WriteBehind {
+            shared,
+            writer: Some(writer),
+        }
+    }
+    /// Register a spec, as `Database::insert_spec_text` would.
+    pub fn insert_spec_text(&self, designation: &str, spec: &str) -> Result<()> {
+        self.shared.db.write()?.insert_spec_text(designation, spec)
+    }
+    /// Enqueue one metadatum and return without touching the database.
+    /// Blocks only when the queue is full, which bounds memory while the
+    /// writer catches up.
+    pub fn insert_metadata(&self, datum: &Metadata) -> Result<()> {
+        let mut state = self.shared.state.lock()?;
+        while state.pending.len() >= DEFAULT_QUEUE_CAPACITY
+            && state.error.is_none()
+            && !state.shutdown
+        {
+            state = self.shared.done.wait(state)?;
+        }
+        if let Some(e) = &state.error {
+            return Err(e.clone());
+        }
+        state.pending.push(QueuedInsert {
+            xmin: datum.xmin,
+            xmax: datum.xmax,
+            ymin: datum.ymin,
+            ymax: datum.ymax,
+            zmin: datum.zmin,
+            zmax: datum.zmax,
+            tmin: datum.tmin,
+            tmax: datum.tmax,
+            designation: datum.designation.to_string(),
+            buffer: datum.buffer.to_vec(),
+        });
+        state.enqueued += 1;
+        self.shared.work.notify_one();
+        Ok(())
+    }
+    /// Durability barrier: block until everything enqueued before this
+    /// call has been committed, surfacing any writer error.
+    pub fn flush(&self) -> Result<()> {
+        let mut state = self.shared.state.lock()?;
+        let target = state.enqueued;
+        while state.committed < target && state.error.is_none() {
+            state = self.shared.done.wait(state)?;
+        }
+        match &state.error {
+            Some(e) => Err(e.clone()),
+            None => Ok(()),
+        }
+    }
+    /// Bounding-box blob query against committed data.
+    #[allow(clippy::too_many_arguments)]
+    pub fn get_metadata_blobs_in_bb(
+        &self,
+        xmin: f64,
+        xmax: f64,
+        ymin: f64,
+        ymax: f64,
+        zmin: f64,
+        zmax: f64,
+        tmin: f64,
+        tmax: f64,
+        designation: &str,
+        epsilon: Option<f64>,
+    ) -> Result<Vec<Vec<u8>>> {
+        self.shared.db.read()?.get_metadata_blobs_in_bb(
+            xmin,
+            xmax,
+            ymin,
+            ymax,
+            zmin,
+            zmax,
+            tmin,
+            tmax,
+            designation,
+            epsilon,
+        )
+    }
+    /// Flush, stop the writer, and recover the database.
+    pub fn into_inner(mut self) -> Result<SqlDatabase> {
+        self.flush()?;
+        self.stop_writer()?;
+        match Arc::try_unwrap(std::mem::replace(
+            &mut self.shared,
+            Arc::new(WriteBehindShared {
+                db: RwLock::new(SqlDatabase::new(None, None)?),
+                state: Mutex::new(QueueState {
+                    pending: Vec::new(),
+                    enqueued: 0,
+                    committed: 0,
+                    shutdown: true,
+                    error: None,
+                }),
+                work: Condvar::new(),
+                done: Condvar::new(),
+            }),
+        )) {
+            Ok(shared) => Ok(shared.db.into_inner()?),
+            Err(_) => Err(DatabaseError::LockError {
+                reason: "Cannot recover database while the writer is live".to_string(),
+            }),
+        }
+    }
+    fn stop_writer(&mut self) -> Result<()> {
+        {
+            let mut state = self.shared.state.lock()?;
+            state.shutdown = true;
+            self.shared.work.notify_one();
+        }
+        if let Some(writer) = self.writer.take() {
+            let _ = writer.join();
+        }
+        Ok(())
+    }
+    /// Writer thread body: sleep until work arrives, then drain the whole
+    /// queue into a single transaction. Batch size adapts to backlog, so
+    /// a burst of inserts amortizes into one commit.
+    fn drain_loop(shared: &WriteBehindShared) {
+        loop {
+            let batch = {
+                let mut state = match shared.state.lock() {
+                    Ok(guard) => guard,
+                    Err(_) => return,
+                };
+                while state.pending.is_empty() && !state.shutdown {
+                    state = match shared.work.wait(state) {
+                        Ok(guard) => guard,
+                        Err(_) => return,
+                    };
+                }
+                if state.pending.is_empty() && state.shutdown {
+                    return;
+                }
+                std::mem::take(&mut state.pending)
+            };
+            let committed = Self::commit_batch(shared, &batch);
+            let mut state = match shared.state.lock() {
+                Ok(guard) => guard,
+                Err(_) => return,
+            };
+            match committed {
+                Ok(()) => state.committed += batch.len() as u64,
+                Err(e) => {
+                    if state.error.is_none() {
+                        state.error = Some(e);
+                    }
+                }
+            }
+            shared.done.notify_all();
+        }
+    }
+    fn commit_batch(shared: &WriteBehindShared, batch: &[QueuedInsert]) -> Result<()> {
+        let views: Vec<Metadata> = batch
+            .iter()
+            .map(|q| Metadata {
+                xmin: q.xmin,
+                xmax: q.xmax,
+                ymin: q.ymin,
+                ymax: q.ymax,
+                zmin: q.zmin,
+                zmax: q.zmax,
+                tmin: q.tmin,
+                tmax: q.tmax,
+                designation: &q.designation,
+                buffer: &q.buffer,
+            })
+            .collect();
+        shared.db.write()?.insert_n_metadata(&views)
+    }
+}
+
+impl Drop for WriteBehind {
+    fn drop(&mut self) {
+        let _ = self.stop_writer();
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    fn spec_db() -> WriteBehind {
+        let db = SqlDatabase::new(None, None).unwrap();
+        let wb = WriteBehind::new(db);
+        wb.insert_spec_text("Foo", "foo: u8").unwrap();
+        wb
+    }
+
+    fn unit_metadata(buffer: &[u8]) -> Metadata {
+        Metadata {
+            xmin: 0.0,
+            xmax: 1.0,
+            ymin: 0.0,
+            ymax: 1.0,
+            zmin: 0.0,
+            zmax: 1.0,
+            tmin: 0.0,
+            tmax: 1.0,
+            designation: "Foo",
+            buffer,
+        }
+    }
+
+    #[test]
+    fn flushed_inserts_are_queryable() {
+        let wb = spec_db();
+        wb.insert_metadata(&unit_metadata(&[42])).unwrap();
+        wb.flush().unwrap();
+
+        let result =
+            wb.get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None);
+
+        pretty_assertions::assert_eq!(result, Ok(vec![vec![42]]),);
+    }
+
+    #[test]
+    fn burst_inserts_all_commit() {
+        let wb = spec_db();
+        for i in 0..500u16 {
+            let buffer = [(i % 251) as u8];
+            wb.insert_metadata(&unit_metadata(&buffer)).unwrap();
+        }
+        wb.flush().unwrap();
+
+        let result = wb
+            .get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None)
+            .unwrap();
+        assert_eq!(result.len(), 500);
+    }
+
+    #[test]
+    fn into_inner_flushes_and_recovers_database() {
+        let wb = spec_db();
+        wb.insert_metadata(&unit_metadata(&[7])).unwrap();
+
+        let db = wb.into_inner().unwrap();
+        let result =
+            db.get_metadata_blobs_in_bb(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, "Foo", None);
+
+        pretty_assertions::assert_eq!(result, Ok(vec![vec![7]]),);
+    }
+}
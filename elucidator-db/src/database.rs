@@ -7,6 +7,19 @@ use rstar::{RTreeObject, AABB};
 pub type Datum<'a> = HashMap<&'a str, DataValue>;
 pub type Result<T, E = DatabaseError> = std::result::Result<T, E>;
 
+/// Query envelope for bounding-box queries, used by the batch query APIs.
+#[derive(Debug, Clone, PartialEq)]
+pub struct BoundingBox {
+    pub xmin: f64,
+    pub xmax: f64,
+    pub ymin: f64,
+    pub ymax: f64,
+    pub zmin: f64,
+    pub zmax: f64,
+    pub tmin: f64,
+    pub tmax: f64,
+}
+
 #[derive(Debug, Clone)]
 pub struct Metadata<'a> {
     pub xmin: f64,
@@ -46,6 +59,21 @@ pub trait Database: Sync {
         designation: &str,
         epsilon: Option<f64>,
     ) -> Result<Vec<Datum>>;
+    /// Fetch the `k` data nearest to a point, closest first, measured by
+    /// euclidean distance to each datum's envelope.
+    fn get_nearest_metadata(
+        &self,
+        x: f64,
+        y: f64,
+        z: f64,
+        t: f64,
+        designation: &str,
+        k: usize,
+    ) -> Result<Vec<Datum>>;
+    /// Fetch the raw, uninterpreted blobs matching a bounding box. The
+    /// buffers are owned by the caller; backends with in-memory storage
+    /// offer zero-copy alternatives (see
+    /// `RTreeDatabase::iter_metadata_blobs_in_bb`).
     #[allow(clippy::too_many_arguments)]
     fn get_metadata_blobs_in_bb(
         &self,
@@ -59,7 +87,14 @@ pub trait Database: Sync {
         tmax: f64,
         designation: &str,
         epsilon: Option<f64>,
-    ) -> Result<Vec<&Vec<u8>>>;
+    ) -> Result<Vec<Vec<u8>>>;
+    /// Snapshot the optional instrumentation: latency histograms, query
+    /// counters, and tree statistics. `None` for backends that carry no
+    /// instruments. Present only with the `instrumentation` feature.
+    #[cfg(feature = "instrumentation")]
+    fn instrumentation_report(&self) -> Option<crate::instrumentation::InstrumentationReport> {
+        None
+    }
 }
 
 pub trait Config {
@@ -0,0 +1,134 @@
+//! Optional hot-path instrumentation, compiled in only with the
+//! `instrumentation` feature. Databases carry a set of [`Instruments`]
+//! and record into them with atomics, so the shared query paths never
+//! take a lock; [`InstrumentationReport`] is the serializable snapshot
+//! handed to callers and to the C API.
+
+use serde::Serialize;
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::Duration;
+
+/// Buckets per latency histogram: bucket `i` counts operations that took
+/// less than `2^i` nanoseconds, with the last bucket unbounded.
+pub const HISTOGRAM_BUCKETS: usize = 32;
+
+/// Concurrent latency histogram with power-of-two nanosecond buckets.
+#[derive(Debug, Default)]
+pub struct LatencyHistogram {
+    buckets: [AtomicU64; HISTOGRAM_BUCKETS],
+    count: AtomicU64,
+    total_ns: AtomicU64,
+}
+
+impl LatencyHistogram {
+    pub fn record(&self, elapsed: Duration) {
+        let ns = elapsed.as_nanos().min(u64::MAX as u128) as u64;
+        let bucket = (64 - ns.leading_zeros() as usize).min(HISTOGRAM_BUCKETS - 1);
+        self.buckets[bucket].fetch_add(1, Ordering::Relaxed);
+        self.count.fetch_add(1, Ordering::Relaxed);
+        self.total_ns.fetch_add(ns, Ordering::Relaxed);
+    }
+    pub fn snapshot(&self) -> HistogramSnapshot {
+        HistogramSnapshot {
+            count: self.count.load(Ordering::Relaxed),
+            total_ns: self.total_ns.load(Ordering::Relaxed),
+            buckets: self.buckets.iter().map(|b| b.load(Ordering::Relaxed)).collect(),
+        }
+    }
+}
+
+/// Point-in-time copy of a [`LatencyHistogram`].
+#[derive(Debug, Clone, PartialEq, Serialize)]
+pub struct HistogramSnapshot {
+    pub count: u64,
+    pub total_ns: u64,
+    pub buckets: Vec<u64>,
+}
+
+/// Totals across queries: envelope candidates found, data returned, and
+/// blobs run through interpretation.
+#[derive(Debug, Default)]
+pub struct QueryCounters {
+    pub candidates: AtomicU64,
+    pub hits: AtomicU64,
+    pub decoded: AtomicU64,
+}
+
+impl QueryCounters {
+    pub fn snapshot(&self) -> CounterSnapshot {
+        CounterSnapshot {
+            candidates: self.candidates.load(Ordering::Relaxed),
+            hits: self.hits.load(Ordering::Relaxed),
+            decoded: self.decoded.load(Ordering::Relaxed),
+        }
+    }
+}
+
+/// Point-in-time copy of [`QueryCounters`].
+#[derive(Debug, Clone, PartialEq, Serialize)]
+pub struct CounterSnapshot {
+    pub candidates: u64,
+    pub hits: u64,
+    pub decoded: u64,
+}
+
+/// The full instrument set a database records into.
+#[derive(Debug, Default)]
+pub struct Instruments {
+    /// Wall time of each insert, including write-ahead logging.
+    pub insert_latency: LatencyHistogram,
+    /// Wall time of each bounding-box query, end to end.
+    pub query_latency: LatencyHistogram,
+    /// Wall time spent interpreting blobs within queries.
+    pub decode_latency: LatencyHistogram,
+    pub counters: QueryCounters,
+}
+
+/// Shape of one designation's tree: entry count, depth from root to
+/// leaves, internal node count, and mean children per internal node.
+#[derive(Debug, Clone, PartialEq, Serialize)]
+pub struct TreeShape {
+    pub designation: String,
+    pub entries: usize,
+    pub depth: usize,
+    pub nodes: usize,
+    pub mean_node_occupancy: f64,
+}
+
+/// Serializable snapshot of every instrument plus tree statistics.
+#[derive(Debug, Clone, PartialEq, Serialize)]
+pub struct InstrumentationReport {
+    pub insert_latency: HistogramSnapshot,
+    pub query_latency: HistogramSnapshot,
+    pub decode_latency: HistogramSnapshot,
+    pub counters: CounterSnapshot,
+    pub trees: Vec<TreeShape>,
+}
+
+impl InstrumentationReport {
+    /// Serialize for export, e.g. through the C API.
+    pub fn to_json(&self) -> String {
+        serde_json::to_string(self).unwrap()
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    #[test]
+    fn histogram_buckets_by_magnitude() {
+        let histogram = LatencyHistogram::default();
+        histogram.record(Duration::from_nanos(1));
+        histogram.record(Duration::from_nanos(1000));
+        histogram.record(Duration::from_secs(3600));
+
+        let snap = histogram.snapshot();
+
+        assert_eq!(snap.count, 3);
+        assert_eq!(snap.buckets[1], 1);
+        assert_eq!(snap.buckets[10], 1);
+        assert_eq!(snap.buckets[HISTOGRAM_BUCKETS - 1], 1);
+    }
+}
@@ -1,4 +1,6 @@
 pub mod database;
 pub mod error;
+#[cfg(feature = "instrumentation")]
+pub mod instrumentation;
 
 pub mod backends;
@@ -1,4 +1,5 @@
 use std::collections::HashMap;
+use std::sync::{Arc, LazyLock, RwLock};
 
 use crate::{
     error::*,
@@ -7,11 +8,17 @@ use crate::{
     representable::Representable,
     util::Buffer,
     validating,
-    value::{DataValue, LeBufferRead},
+    value::{Column, ColumnValues, ColumnarData, DataValue, LeBufferRead},
 };
 
 type Result<T, E = ElucidatorError> = std::result::Result<T, E>;
 
+/// Process-wide cache mapping specification text to its parsed, shared
+/// form, so repeated registration of the same text is a lookup rather
+/// than a re-parse. Failed parses are not cached.
+static SPEC_CACHE: LazyLock<RwLock<HashMap<String, Arc<DesignationSpecification>>>> =
+    LazyLock::new(|| RwLock::new(HashMap::new()));
+
 /// Representation of a Designation's specification.
 /// Use to parse a specification for an individual designation.
 /// To construct, it is typical to use the `from_text` method.
@@ -278,6 +285,279 @@ fn get_array_from_buf(buffer: &mut Buffer, dt: &Dtype, items_to_read: usize) ->
     }
 }
 
+/// Interpreter produced once from a [`DesignationSpecification`] with
+/// precomputed member byte offsets. When every member has a statically known
+/// size, each blob is decoded with direct offset reads instead of walking the
+/// member list and tracking a cursor; specs containing dynamic arrays or
+/// strings fall back to the general interpretation path.
+#[derive(Debug, PartialEq, Clone)]
+pub struct CompiledInterpreter {
+    spec: DesignationSpecification,
+    /// Present when every member's size is statically known
+    fixed: Option<FixedLayout>,
+}
+
+#[derive(Debug, PartialEq, Clone)]
+struct FixedLayout {
+    members: Vec<CompiledMember>,
+    /// Minimum number of bytes a conforming blob must contain
+    buffer_size: usize,
+}
+
+#[derive(Debug, PartialEq, Clone)]
+struct CompiledMember {
+    identifier: String,
+    dtype: Dtype,
+    offset: usize,
+    /// Item count for fixed arrays; `None` for singletons
+    items: Option<usize>,
+}
+
+fn decode_singleton_at(buffer: &[u8], dt: &Dtype) -> Result<DataValue> {
+    match dt {
+        Dtype::Byte => Ok(DataValue::Byte(u8::get_one_le(buffer)?)),
+        Dtype::UnsignedInteger16 => Ok(DataValue::UnsignedInteger16(u16::get_one_le(buffer)?)),
+        Dtype::UnsignedInteger32 => Ok(DataValue::UnsignedInteger32(u32::get_one_le(buffer)?)),
+        Dtype::UnsignedInteger64 => Ok(DataValue::UnsignedInteger64(u64::get_one_le(buffer)?)),
+        Dtype::SignedInteger8 => Ok(DataValue::SignedInteger8(i8::get_one_le(buffer)?)),
+        Dtype::SignedInteger16 => Ok(DataValue::SignedInteger16(i16::get_one_le(buffer)?)),
+        Dtype::SignedInteger32 => Ok(DataValue::SignedInteger32(i32::get_one_le(buffer)?)),
+        Dtype::SignedInteger64 => Ok(DataValue::SignedInteger64(i64::get_one_le(buffer)?)),
+        Dtype::Float32 => Ok(DataValue::Float32(f32::get_one_le(buffer)?)),
+        Dtype::Float64 => Ok(DataValue::Float64(f64::get_one_le(buffer)?)),
+        Dtype::Str => {
+            unreachable!("Strings never appear in a fixed layout");
+        }
+    }
+}
+
+fn decode_array_at(buffer: &[u8], dt: &Dtype, n: usize) -> Result<DataValue> {
+    match dt {
+        Dtype::Byte => Ok(DataValue::ByteArray(u8::get_n_le(buffer, n)?)),
+        Dtype::UnsignedInteger16 => {
+            Ok(DataValue::UnsignedInteger16Array(u16::get_n_le(buffer, n)?))
+        }
+        Dtype::UnsignedInteger32 => {
+            Ok(DataValue::UnsignedInteger32Array(u32::get_n_le(buffer, n)?))
+        }
+        Dtype::UnsignedInteger64 => {
+            Ok(DataValue::UnsignedInteger64Array(u64::get_n_le(buffer, n)?))
+        }
+        Dtype::SignedInteger8 => Ok(DataValue::SignedInteger8Array(i8::get_n_le(buffer, n)?)),
+        Dtype::SignedInteger16 => Ok(DataValue::SignedInteger16Array(i16::get_n_le(buffer, n)?)),
+        Dtype::SignedInteger32 => Ok(DataValue::SignedInteger32Array(i32::get_n_le(buffer, n)?)),
+        Dtype::SignedInteger64 => Ok(DataValue::SignedInteger64Array(i64::get_n_le(buffer, n)?)),
+        Dtype::Float32 => Ok(DataValue::Float32Array(f32::get_n_le(buffer, n)?)),
+        Dtype::Float64 => Ok(DataValue::Float64Array(f64::get_n_le(buffer, n)?)),
+        Dtype::Str => {
+            unreachable!("Strings never appear in a fixed layout");
+        }
+    }
+}
+
+fn extend_column<T: LeBufferRead>(
+    values: &mut Vec<T>,
+    blobs: &[&[u8]],
+    offset: usize,
+    items: usize,
+) -> Result<()> {
+    for blob in blobs {
+        if items == 1 {
+            values.push(T::get_one_le(&blob[offset..])?);
+        } else {
+            values.extend(T::get_n_le(&blob[offset..], items)?);
+        }
+    }
+    Ok(())
+}
+
+fn push_column_value(column: &mut ColumnValues, value: DataValue) {
+    match (column, value) {
+        (ColumnValues::Byte(v), DataValue::Byte(x)) => v.push(x),
+        (ColumnValues::Byte(v), DataValue::ByteArray(xs)) => v.extend(xs),
+        (ColumnValues::UnsignedInteger16(v), DataValue::UnsignedInteger16(x)) => v.push(x),
+        (ColumnValues::UnsignedInteger16(v), DataValue::UnsignedInteger16Array(xs)) => v.extend(xs),
+        (ColumnValues::UnsignedInteger32(v), DataValue::UnsignedInteger32(x)) => v.push(x),
+        (ColumnValues::UnsignedInteger32(v), DataValue::UnsignedInteger32Array(xs)) => v.extend(xs),
+        (ColumnValues::UnsignedInteger64(v), DataValue::UnsignedInteger64(x)) => v.push(x),
+        (ColumnValues::UnsignedInteger64(v), DataValue::UnsignedInteger64Array(xs)) => v.extend(xs),
+        (ColumnValues::SignedInteger8(v), DataValue::SignedInteger8(x)) => v.push(x),
+        (ColumnValues::SignedInteger8(v), DataValue::SignedInteger8Array(xs)) => v.extend(xs),
+        (ColumnValues::SignedInteger16(v), DataValue::SignedInteger16(x)) => v.push(x),
+        (ColumnValues::SignedInteger16(v), DataValue::SignedInteger16Array(xs)) => v.extend(xs),
+        (ColumnValues::SignedInteger32(v), DataValue::SignedInteger32(x)) => v.push(x),
+        (ColumnValues::SignedInteger32(v), DataValue::SignedInteger32Array(xs)) => v.extend(xs),
+        (ColumnValues::SignedInteger64(v), DataValue::SignedInteger64(x)) => v.push(x),
+        (ColumnValues::SignedInteger64(v), DataValue::SignedInteger64Array(xs)) => v.extend(xs),
+        (ColumnValues::Float32(v), DataValue::Float32(x)) => v.push(x),
+        (ColumnValues::Float32(v), DataValue::Float32Array(xs)) => v.extend(xs),
+        (ColumnValues::Float64(v), DataValue::Float64(x)) => v.push(x),
+        (ColumnValues::Float64(v), DataValue::Float64Array(xs)) => v.extend(xs),
+        (ColumnValues::Str(v), DataValue::Str(x)) => v.push(x),
+        _ => {
+            unreachable!("Member dtype and column dtype always agree");
+        }
+    }
+}
+
+impl CompiledInterpreter {
+    /// Interpret a buffer, using precomputed offsets when the spec allows.
+    pub fn interpret_enum(&self, buffer: &[u8]) -> Result<HashMap<&str, DataValue>> {
+        let layout = match &self.fixed {
+            Some(layout) => layout,
+            None => return self.spec.interpret_enum(buffer),
+        };
+        if buffer.len() < layout.buffer_size {
+            Err(ElucidatorError::BufferSizing {
+                expected: layout.buffer_size,
+                found: buffer.len(),
+            })?
+        }
+        let mut map = HashMap::with_capacity(layout.members.len());
+        for member in &layout.members {
+            let value = match member.items {
+                None => decode_singleton_at(&buffer[member.offset..], &member.dtype)?,
+                Some(n) => decode_array_at(&buffer[member.offset..], &member.dtype, n)?,
+            };
+            map.insert(member.identifier.as_str(), value);
+        }
+        Ok(map)
+    }
+
+    /// Whether the spec declares a member with this identifier.
+    pub fn has_member(&self, identifier: &str) -> bool {
+        self.spec.members.iter().any(|m| m.identifier == identifier)
+    }
+
+    /// Whether the spec declares a numeric singleton member with this
+    /// identifier, i.e. one that can be compared as a number.
+    pub fn has_numeric_singleton_member(&self, identifier: &str) -> bool {
+        self.spec.members.iter().any(|m| {
+            m.identifier == identifier && m.sizing == Sizing::Singleton && m.dtype != Dtype::Str
+        })
+    }
+
+    /// Decode one member from a blob without interpreting the rest. With a
+    /// fixed layout this is a single offset read; otherwise the whole blob
+    /// is interpreted and the member picked out.
+    pub fn extract_member(&self, identifier: &str, buffer: &[u8]) -> Result<DataValue> {
+        if let Some(layout) = &self.fixed {
+            if let Some(member) = layout.members.iter().find(|m| m.identifier == identifier) {
+                if buffer.len() < layout.buffer_size {
+                    Err(ElucidatorError::BufferSizing {
+                        expected: layout.buffer_size,
+                        found: buffer.len(),
+                    })?
+                }
+                return match member.items {
+                    None => decode_singleton_at(&buffer[member.offset..], &member.dtype),
+                    Some(n) => decode_array_at(&buffer[member.offset..], &member.dtype, n),
+                };
+            }
+        } else if let Some(value) = self.spec.interpret_enum(buffer)?.remove(identifier) {
+            return Ok(value);
+        }
+        Err(ElucidatorError::Unsupported {
+            reason: format!("No member \"{identifier}\" to extract"),
+        })
+    }
+
+    /// Interpret a batch of blobs into contiguous per-member columns in a
+    /// single pass. Every member must have a statically known item count;
+    /// dynamically sized members are not supported.
+    pub fn interpret_many(&self, blobs: &[&[u8]]) -> Result<ColumnarData> {
+        for member in &self.spec.members {
+            if member.sizing == Sizing::Dynamic {
+                Err(ElucidatorError::Unsupported {
+                    reason: format!(
+                        "columnar interpretation requires fixed-size members, but \"{}\" is dynamically sized",
+                        member.identifier
+                    ),
+                })?
+            }
+        }
+        let mut columns: HashMap<String, Column> = self
+            .spec
+            .members
+            .iter()
+            .map(|member| {
+                let items_per_row = match member.sizing {
+                    Sizing::Fixed(n) => n as usize,
+                    _ => 1,
+                };
+                let values =
+                    ColumnValues::with_capacity(&member.dtype, blobs.len() * items_per_row);
+                (
+                    member.identifier.clone(),
+                    Column {
+                        items_per_row,
+                        values,
+                    },
+                )
+            })
+            .collect();
+        if let Some(layout) = &self.fixed {
+            for blob in blobs {
+                if blob.len() < layout.buffer_size {
+                    Err(ElucidatorError::BufferSizing {
+                        expected: layout.buffer_size,
+                        found: blob.len(),
+                    })?
+                }
+            }
+            for member in &layout.members {
+                let items = member.items.unwrap_or(1);
+                let column = columns.get_mut(member.identifier.as_str()).unwrap();
+                match (&member.dtype, &mut column.values) {
+                    (Dtype::Byte, ColumnValues::Byte(v)) => {
+                        extend_column(v, blobs, member.offset, items)?
+                    }
+                    (Dtype::UnsignedInteger16, ColumnValues::UnsignedInteger16(v)) => {
+                        extend_column(v, blobs, member.offset, items)?
+                    }
+                    (Dtype::UnsignedInteger32, ColumnValues::UnsignedInteger32(v)) => {
+                        extend_column(v, blobs, member.offset, items)?
+                    }
+                    (Dtype::UnsignedInteger64, ColumnValues::UnsignedInteger64(v)) => {
+                        extend_column(v, blobs, member.offset, items)?
+                    }
+                    (Dtype::SignedInteger8, ColumnValues::SignedInteger8(v)) => {
+                        extend_column(v, blobs, member.offset, items)?
+                    }
+                    (Dtype::SignedInteger16, ColumnValues::SignedInteger16(v)) => {
+                        extend_column(v, blobs, member.offset, items)?
+                    }
+                    (Dtype::SignedInteger32, ColumnValues::SignedInteger32(v)) => {
+                        extend_column(v, blobs, member.offset, items)?
+                    }
+                    (Dtype::SignedInteger64, ColumnValues::SignedInteger64(v)) => {
+                        extend_column(v, blobs, member.offset, items)?
+                    }
+                    (Dtype::Float32, ColumnValues::Float32(v)) => {
+                        extend_column(v, blobs, member.offset, items)?
+                    }
+                    (Dtype::Float64, ColumnValues::Float64(v)) => {
+                        extend_column(v, blobs, member.offset, items)?
+                    }
+                    _ => {
+                        unreachable!("Member dtype and column dtype always agree");
+                    }
+                }
+            }
+        } else {
+            for blob in blobs {
+                let mut map = self.spec.interpret_enum(blob)?;
+                for member in &self.spec.members {
+                    let value = map.remove(member.identifier.as_str()).unwrap();
+                    let column = columns.get_mut(member.identifier.as_str()).unwrap();
+                    push_column_value(&mut column.values, value);
+                }
+            }
+        }
+        Ok(ColumnarData::new(blobs.len(), columns))
+    }
+}
+
 impl DesignationSpecification {
     pub fn from_text(text: &str) -> Result<Self> {
         let parsed = parsing::get_metadataspec(text);
@@ -288,6 +568,34 @@ impl DesignationSpecification {
         }
     }
 
+    /// Produce a specification from text through the process-wide parse
+    /// cache. The first registration of a given text parses it; every
+    /// subsequent one is a map lookup returning the same shared,
+    /// immutable specification.
+    /// ```
+    /// use elucidator::designation::DesignationSpecification;
+    ///
+    /// let first = DesignationSpecification::from_text_cached("foo: u32").unwrap();
+    /// let second = DesignationSpecification::from_text_cached("foo: u32").unwrap();
+    ///
+    /// assert!(DesignationSpecification::same(&first, &second));
+    /// ```
+    pub fn from_text_cached(text: &str) -> Result<Arc<Self>> {
+        if let Some(spec) = SPEC_CACHE.read().unwrap().get(text) {
+            return Ok(Arc::clone(spec));
+        }
+        let spec = Arc::new(Self::from_text(text)?);
+        let mut cache = SPEC_CACHE.write().unwrap();
+        Ok(Arc::clone(cache.entry(text.to_string()).or_insert(spec)))
+    }
+
+    /// Equality fast-path for shared specifications. Specs obtained from
+    /// `from_text_cached` with the same text share one allocation, so
+    /// pointer identity decides equality without comparing members.
+    pub fn same(a: &Arc<Self>, b: &Arc<Self>) -> bool {
+        Arc::ptr_eq(a, b) || a == b
+    }
+
     pub fn interpret(&self, buffer: &[u8]) -> Result<HashMap<&str, Box<dyn Representable>>> {
         let mut map = HashMap::new();
         let mut buf = Buffer::new(buffer);
@@ -308,6 +616,58 @@ impl DesignationSpecification {
         Ok(map)
     }
 
+    /// Produce an interpreter with precomputed member offsets. Compile once
+    /// per spec and reuse across blobs; the per-blob cost for fully
+    /// fixed-size specs is then a handful of bounds-checked reads.
+    pub fn compile(&self) -> CompiledInterpreter {
+        let mut members = Vec::with_capacity(self.members.len());
+        let mut offset = 0;
+        let mut is_fixed = true;
+        for member in &self.members {
+            let dtype_size = match member.dtype.get_size() {
+                Some(size) => size,
+                None => {
+                    is_fixed = false;
+                    break;
+                }
+            };
+            let items = match member.sizing {
+                Sizing::Singleton => None,
+                Sizing::Fixed(n) => Some(n as usize),
+                Sizing::Dynamic => {
+                    is_fixed = false;
+                    break;
+                }
+            };
+            members.push(CompiledMember {
+                identifier: member.identifier.clone(),
+                dtype: member.dtype.clone(),
+                offset,
+                items,
+            });
+            offset += dtype_size * items.unwrap_or(1);
+        }
+        let fixed = if is_fixed {
+            Some(FixedLayout {
+                members,
+                buffer_size: offset,
+            })
+        } else {
+            None
+        };
+        CompiledInterpreter {
+            spec: self.clone(),
+            fixed,
+        }
+    }
+
+    /// Interpret a batch of blobs into contiguous per-member columns; see
+    /// [`CompiledInterpreter::interpret_many`]. Compile once and reuse the
+    /// interpreter when many batches share a spec.
+    pub fn interpret_many(&self, blobs: &[&[u8]]) -> Result<ColumnarData> {
+        self.compile().interpret_many(blobs)
+    }
+
     pub fn interpret_enum(&self, buffer: &[u8]) -> Result<HashMap<&str, DataValue>> {
         let mut map = HashMap::new();
         let mut buf = Buffer::new(buffer);
@@ -634,6 +994,25 @@ mod test {
         assert_eq!(val, result_val);
     }
 
+    #[test]
+    fn extract_member_fixed_ok() {
+        let text = "foo: u8, bar: f64";
+        let interpreter = DesignationSpecification::from_text(text).unwrap().compile();
+        let mut buffer = vec![7u8];
+        buffer.extend(2.5f64.to_le_bytes());
+        let result = interpreter.extract_member("bar", &buffer);
+        assert_eq!(result, Ok(DataValue::Float64(2.5)));
+    }
+
+    #[test]
+    fn extract_member_missing_err() {
+        let text = "foo: u8";
+        let interpreter = DesignationSpecification::from_text(text).unwrap().compile();
+        let result = interpreter.extract_member("bar", &[7u8]);
+        assert!(result.is_err());
+        assert!(!interpreter.has_member("bar"));
+    }
+
     fn random_data_value(dt: &Dtype, sizing: &Sizing) -> DataValue {
         let items = match sizing {
             Sizing::Singleton => 1,
@@ -858,6 +1237,13 @@ mod test {
                 "{designation:#?}\nBuffer size {}",
                 buffer.len()
             );
+            let compiled = designation.compile();
+            pretty_assertions::assert_eq!(
+                compiled.interpret_enum(&buffer),
+                dr,
+                "{designation:#?}\nBuffer size {}",
+                buffer.len()
+            );
         }
     }
 
@@ -920,4 +1306,114 @@ mod test {
             generate_designation_and_perform_round_trip()
         }
     }
+
+    #[test]
+    fn compiled_fixed_spec_ok() {
+        let hm = HashMap::from([
+            ("foo", DataValue::Byte(9)),
+            ("bar", DataValue::Float32Array(vec![-5.0, -10.0, 3.14])),
+        ]);
+        let buff_foo = hm.get("foo").unwrap().as_buffer();
+        let buff_bar = hm.get("bar").unwrap().as_buffer();
+        let buffer: Vec<u8> = buff_foo.iter().chain(buff_bar.iter()).copied().collect();
+        let designation = DesignationSpecification::from_text("foo: u8, bar: f32[3]").unwrap();
+        let compiled = designation.compile();
+        assert!(compiled.fixed.is_some());
+        pretty_assertions::assert_eq!(compiled.interpret_enum(&buffer), Ok(hm),);
+    }
+
+    #[test]
+    fn cached_parse_shares_one_spec() {
+        let first = DesignationSpecification::from_text_cached("cached: u8, spec: f32").unwrap();
+        let second = DesignationSpecification::from_text_cached("cached: u8, spec: f32").unwrap();
+        assert!(Arc::ptr_eq(&first, &second));
+        assert!(DesignationSpecification::same(&first, &second));
+        pretty_assertions::assert_eq!(
+            *first,
+            DesignationSpecification::from_text("cached: u8, spec: f32").unwrap(),
+        );
+    }
+
+    #[test]
+    fn cached_parse_invalid_err() {
+        assert!(DesignationSpecification::from_text_cached("foo u32").is_err());
+    }
+
+    #[test]
+    fn compiled_dynamic_spec_falls_back() {
+        let designation = DesignationSpecification::from_text("foo: u32[], bar: string").unwrap();
+        let compiled = designation.compile();
+        assert!(compiled.fixed.is_none());
+    }
+
+    #[test]
+    fn interpret_many_fixed_ok() {
+        let designation = DesignationSpecification::from_text("foo: u8, bar: f32[2]").unwrap();
+        let blob_a: Vec<u8> = [9u8]
+            .iter()
+            .copied()
+            .chain(DataValue::Float32Array(vec![1.0, 2.0]).as_buffer())
+            .collect();
+        let blob_b: Vec<u8> = [10u8]
+            .iter()
+            .copied()
+            .chain(DataValue::Float32Array(vec![3.0, 4.0]).as_buffer())
+            .collect();
+        let blobs: Vec<&[u8]> = vec![&blob_a, &blob_b];
+        let columnar = designation.interpret_many(&blobs).unwrap();
+        assert_eq!(columnar.rows(), 2);
+        let foo = columnar.column("foo").unwrap();
+        assert_eq!(foo.items_per_row, 1);
+        pretty_assertions::assert_eq!(foo.values, ColumnValues::Byte(vec![9, 10]));
+        let bar = columnar.column("bar").unwrap();
+        assert_eq!(bar.items_per_row, 2);
+        pretty_assertions::assert_eq!(
+            bar.values,
+            ColumnValues::Float32(vec![1.0, 2.0, 3.0, 4.0])
+        );
+    }
+
+    #[test]
+    fn interpret_many_with_string_ok() {
+        let designation = DesignationSpecification::from_text("foo: u16, bar: string").unwrap();
+        let blob: Vec<u8> = DataValue::UnsignedInteger16(7)
+            .as_buffer()
+            .into_iter()
+            .chain(DataValue::Str("hi".to_string()).as_buffer())
+            .collect();
+        let blobs: Vec<&[u8]> = vec![&blob];
+        let columnar = designation.interpret_many(&blobs).unwrap();
+        pretty_assertions::assert_eq!(
+            columnar.column("foo").unwrap().values,
+            ColumnValues::UnsignedInteger16(vec![7]),
+        );
+        pretty_assertions::assert_eq!(
+            columnar.column("bar").unwrap().values,
+            ColumnValues::Str(vec!["hi".to_string()]),
+        );
+    }
+
+    #[test]
+    fn interpret_many_dynamic_unsupported() {
+        let designation = DesignationSpecification::from_text("foo: u32[]").unwrap();
+        let result = designation.interpret_many(&[]);
+        assert!(matches!(
+            result,
+            Err(ElucidatorError::Unsupported { .. })
+        ));
+    }
+
+    #[test]
+    fn compiled_undersized_buffer_err() {
+        let designation = DesignationSpecification::from_text("foo: u32").unwrap();
+        let compiled = designation.compile();
+        let buffer = [0u8; 2];
+        pretty_assertions::assert_eq!(
+            compiled.interpret_enum(&buffer),
+            Err(ElucidatorError::BufferSizing {
+                expected: 4,
+                found: 2,
+            }),
+        );
+    }
 }
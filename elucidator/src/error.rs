@@ -18,6 +18,8 @@ pub enum ElucidatorError {
         column_end: usize,
         reason: String,
     },
+    /// Operations not supported by the requested interpretation mode
+    Unsupported { reason: String },
     /// Multiple, simultaneous failures
     MultipleErrors(Box<Vec<ElucidatorError>>),
 }
@@ -79,6 +81,9 @@ impl fmt::Display for ElucidatorError {
             } => {
                 format!("Error {reason} between positions {column_start} and {column_end}:\n{context}\n")
             }
+            Self::Unsupported { reason } => {
+                format!("Unsupported operation: {reason}")
+            }
             Self::MultipleErrors(errs) => errs
                 .iter()
                 .map(|x| format!("{x}"))
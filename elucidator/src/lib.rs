@@ -1,5 +1,6 @@
 //! Main elucidator library.
 use crate::error::*;
+pub use elucidator_macros::Elucidate;
 pub use representable::Representable;
 
 pub mod designation;
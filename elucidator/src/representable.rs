@@ -125,6 +125,15 @@ pub trait Representable {
     fn is_floating(&self) -> bool;
     /// Produce an equivalent buffer of bytes
     fn as_buffer(&self) -> Vec<u8>;
+    /// Append this value's byte representation to `buf`, returning the
+    /// number of bytes written. The default routes through `as_buffer`;
+    /// implementations in this crate write directly, so encoding into a
+    /// reused buffer performs no temporary allocation.
+    fn write_to(&self, buf: &mut Vec<u8>) -> usize {
+        let bytes = self.as_buffer();
+        buf.extend_from_slice(&bytes);
+        bytes.len()
+    }
     /// Attempt to convert this type into a u8
     fn as_u8(&self) -> Result<u8, ElucidatorError>;
     /// Attempt to convert this type into a u16
@@ -210,6 +219,13 @@ impl Representable for String {
         final_buffer.append(&mut contents_buffer);
         final_buffer
     }
+    fn write_to(&self, buf: &mut Vec<u8>) -> usize {
+        let contents = self.as_bytes();
+        buf.reserve(8 + contents.len());
+        buf.extend_from_slice(&(contents.len() as u64).to_le_bytes());
+        buf.extend_from_slice(contents);
+        8 + contents.len()
+    }
     fn as_u8(&self) -> Result<u8, ElucidatorError> {
         ElucidatorError::new_conversion("string", "u8")
     }
@@ -1,4 +1,5 @@
-use crate::{error::ElucidatorError, representable::Representable};
+use crate::{error::ElucidatorError, member::Dtype, representable::Representable};
+use std::collections::HashMap;
 
 type Result<T, E = ElucidatorError> = std::result::Result<T, E>;
 
@@ -54,6 +55,161 @@ impl DataValue {
             Self::Float64Array(v) => v.as_buffer(),
         }
     }
+    /// Append this value's byte representation to `buf`, returning the
+    /// number of bytes written. Unlike [`DataValue::as_buffer`], no
+    /// temporary allocation is made, so encoding into a reused buffer is
+    /// allocation-free in steady state.
+    pub fn write_to(&self, buf: &mut Vec<u8>) -> usize {
+        match self {
+            Self::Byte(v) => v.write_to(buf),
+            Self::UnsignedInteger16(v) => v.write_to(buf),
+            Self::UnsignedInteger32(v) => v.write_to(buf),
+            Self::UnsignedInteger64(v) => v.write_to(buf),
+            Self::SignedInteger8(v) => v.write_to(buf),
+            Self::SignedInteger16(v) => v.write_to(buf),
+            Self::SignedInteger32(v) => v.write_to(buf),
+            Self::SignedInteger64(v) => v.write_to(buf),
+            Self::Float32(v) => v.write_to(buf),
+            Self::Float64(v) => v.write_to(buf),
+            Self::Str(s) => s.write_to(buf),
+            Self::ByteArray(v) => v.write_to(buf),
+            Self::UnsignedInteger16Array(v) => v.write_to(buf),
+            Self::UnsignedInteger32Array(v) => v.write_to(buf),
+            Self::UnsignedInteger64Array(v) => v.write_to(buf),
+            Self::SignedInteger8Array(v) => v.write_to(buf),
+            Self::SignedInteger16Array(v) => v.write_to(buf),
+            Self::SignedInteger32Array(v) => v.write_to(buf),
+            Self::SignedInteger64Array(v) => v.write_to(buf),
+            Self::Float32Array(v) => v.write_to(buf),
+            Self::Float64Array(v) => v.write_to(buf),
+        }
+    }
+}
+
+/// Reusable scratch for building insert payloads. Clearing retains the
+/// backing allocation, so encoding a stream of data settles into zero
+/// steady-state heap traffic.
+#[derive(Clone, Debug, Default, PartialEq)]
+pub struct SerializationBuffer {
+    buf: Vec<u8>,
+}
+
+impl SerializationBuffer {
+    pub fn new() -> Self {
+        Self::default()
+    }
+    /// Discard the contents but keep the capacity for the next datum.
+    pub fn clear(&mut self) {
+        self.buf.clear();
+    }
+    /// Append one value, returning the number of bytes written.
+    pub fn write(&mut self, value: &DataValue) -> usize {
+        value.write_to(&mut self.buf)
+    }
+    /// Append one representable value, returning the bytes written.
+    pub fn write_representable(&mut self, value: &dyn Representable) -> usize {
+        value.write_to(&mut self.buf)
+    }
+    /// The encoded bytes accumulated since the last clear.
+    pub fn bytes(&self) -> &[u8] {
+        &self.buf
+    }
+    pub fn len(&self) -> usize {
+        self.buf.len()
+    }
+    pub fn is_empty(&self) -> bool {
+        self.buf.is_empty()
+    }
+}
+
+/// Contiguous values for one member across every row of a batch.
+#[derive(Clone, Debug, PartialEq)]
+pub enum ColumnValues {
+    Byte(Vec<u8>),
+    UnsignedInteger16(Vec<u16>),
+    UnsignedInteger32(Vec<u32>),
+    UnsignedInteger64(Vec<u64>),
+    SignedInteger8(Vec<i8>),
+    SignedInteger16(Vec<i16>),
+    SignedInteger32(Vec<i32>),
+    SignedInteger64(Vec<i64>),
+    Float32(Vec<f32>),
+    Float64(Vec<f64>),
+    Str(Vec<String>),
+}
+
+impl ColumnValues {
+    pub(crate) fn with_capacity(dtype: &Dtype, capacity: usize) -> Self {
+        match dtype {
+            Dtype::Byte => Self::Byte(Vec::with_capacity(capacity)),
+            Dtype::UnsignedInteger16 => Self::UnsignedInteger16(Vec::with_capacity(capacity)),
+            Dtype::UnsignedInteger32 => Self::UnsignedInteger32(Vec::with_capacity(capacity)),
+            Dtype::UnsignedInteger64 => Self::UnsignedInteger64(Vec::with_capacity(capacity)),
+            Dtype::SignedInteger8 => Self::SignedInteger8(Vec::with_capacity(capacity)),
+            Dtype::SignedInteger16 => Self::SignedInteger16(Vec::with_capacity(capacity)),
+            Dtype::SignedInteger32 => Self::SignedInteger32(Vec::with_capacity(capacity)),
+            Dtype::SignedInteger64 => Self::SignedInteger64(Vec::with_capacity(capacity)),
+            Dtype::Float32 => Self::Float32(Vec::with_capacity(capacity)),
+            Dtype::Float64 => Self::Float64(Vec::with_capacity(capacity)),
+            Dtype::Str => Self::Str(Vec::with_capacity(capacity)),
+        }
+    }
+    pub fn len(&self) -> usize {
+        match self {
+            Self::Byte(v) => v.len(),
+            Self::UnsignedInteger16(v) => v.len(),
+            Self::UnsignedInteger32(v) => v.len(),
+            Self::UnsignedInteger64(v) => v.len(),
+            Self::SignedInteger8(v) => v.len(),
+            Self::SignedInteger16(v) => v.len(),
+            Self::SignedInteger32(v) => v.len(),
+            Self::SignedInteger64(v) => v.len(),
+            Self::Float32(v) => v.len(),
+            Self::Float64(v) => v.len(),
+            Self::Str(v) => v.len(),
+        }
+    }
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+}
+
+/// A single member's decoded column.
+#[derive(Clone, Debug, PartialEq)]
+pub struct Column {
+    /// Elements each row contributes to `values`; 1 for singletons, the
+    /// array length for fixed arrays
+    pub items_per_row: usize,
+    pub values: ColumnValues,
+}
+
+/// Struct-of-arrays result of interpreting a batch of blobs which share a
+/// designation. Each member decodes into one contiguous vector in row order.
+#[derive(Clone, Debug, PartialEq)]
+pub struct ColumnarData {
+    rows: usize,
+    columns: HashMap<String, Column>,
+}
+
+impl ColumnarData {
+    pub(crate) fn new(rows: usize, columns: HashMap<String, Column>) -> Self {
+        ColumnarData { rows, columns }
+    }
+    /// Number of blobs interpreted into this batch.
+    pub fn rows(&self) -> usize {
+        self.rows
+    }
+    pub fn column(&self, identifier: &str) -> Option<&Column> {
+        self.columns.get(identifier)
+    }
+    pub fn columns(&self) -> &HashMap<String, Column> {
+        &self.columns
+    }
+    /// Consume the batch, handing ownership of the column buffers to the
+    /// caller so they can be moved across an FFI boundary without copying.
+    pub fn into_columns(self) -> HashMap<String, Column> {
+        self.columns
+    }
 }
 
 pub(crate) trait LeBufferRead: Sized {
@@ -86,9 +242,30 @@ macro_rules! impl_le_bufread {
                             found: buf.len(),
                         })?
                     }
-                    if n == 0 && buf.len() == 0 {
-                        Ok(Vec::new())
-                    } else {
+                    if n == 0 {
+                        return Ok(Vec::new());
+                    }
+                    #[cfg(target_endian = "little")]
+                    {
+                        // The wire format matches the in-memory layout on
+                        // little-endian targets, so the whole array decodes
+                        // with one wide copy instead of per-element reads.
+                        let mut values: Vec<$tt> = Vec::with_capacity(n);
+                        // SAFETY: the destination was allocated for n
+                        // elements, every bit pattern is a valid $tt, and
+                        // the source holds at least expected_bytes bytes.
+                        unsafe {
+                            std::ptr::copy_nonoverlapping(
+                                buf.as_ptr(),
+                                values.as_mut_ptr() as *mut u8,
+                                expected_bytes,
+                            );
+                            values.set_len(n);
+                        }
+                        Ok(values)
+                    }
+                    #[cfg(not(target_endian = "little"))]
+                    {
                         Ok(buf[..expected_bytes]
                             .chunks_exact(std::mem::size_of::<$tt>())
                             .map(|x|
@@ -141,6 +318,38 @@ mod test {
     use pretty_assertions;
     use rand::random;
 
+    #[test]
+    fn write_to_matches_as_buffer() {
+        let values = vec![
+            DataValue::Byte(random()),
+            DataValue::SignedInteger32(random()),
+            DataValue::Float64(random()),
+            DataValue::Str("serialize me".to_string()),
+            DataValue::UnsignedInteger32Array((0..10).map(|_| random()).collect()),
+            DataValue::Float32Array((0..7).map(|_| random()).collect()),
+        ];
+        for value in values {
+            let mut buf = Vec::new();
+            let written = value.write_to(&mut buf);
+            pretty_assertions::assert_eq!(buf, value.as_buffer(), "Value is {value:#?}");
+            assert_eq!(written, buf.len());
+        }
+    }
+
+    #[test]
+    fn serialization_buffer_reuses_capacity() {
+        let mut scratch = SerializationBuffer::new();
+        scratch.write(&DataValue::UnsignedInteger64Array(vec![0; 64]));
+        let capacity_after_first = scratch.bytes().len();
+        assert_eq!(capacity_after_first, 64 * 8);
+        scratch.clear();
+        assert!(scratch.is_empty());
+        scratch.write(&DataValue::Byte(3));
+        scratch.write_representable(&7u16);
+        pretty_assertions::assert_eq!(scratch.bytes(), &[3u8, 7, 0][..]);
+        assert_eq!(scratch.len(), 3);
+    }
+
     macro_rules! singleton_round_trip {
         ($($tt:ty), *) => {
             $(
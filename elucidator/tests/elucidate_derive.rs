@@ -0,0 +1,57 @@
+use elucidator::designation::DesignationSpecification;
+use elucidator::error::ElucidatorError;
+use elucidator::Elucidate;
+use elucidator::Representable;
+
+#[derive(Debug, PartialEq, Elucidate)]
+#[spec("foo: u8, bar: f32[3], baz: i64")]
+struct Sample {
+    foo: u8,
+    bar: [f32; 3],
+    baz: i64,
+}
+
+fn sample_buffer() -> Vec<u8> {
+    let foo = 9u8.as_buffer();
+    let bar = vec![-5.0f32, -10.0, 3.14].as_buffer();
+    let baz = (-40i64).as_buffer();
+    foo.iter()
+        .chain(bar.iter())
+        .chain(baz.iter())
+        .copied()
+        .collect()
+}
+
+#[test]
+fn derive_decodes_fixed_spec() {
+    let decoded = Sample::from_buffer(&sample_buffer()).unwrap();
+    pretty_assertions::assert_eq!(
+        decoded,
+        Sample {
+            foo: 9,
+            bar: [-5.0, -10.0, 3.14],
+            baz: -40,
+        },
+    );
+}
+
+#[test]
+fn derive_buffer_size_matches_interpreter() {
+    let spec = DesignationSpecification::from_text("foo: u8, bar: f32[3], baz: i64").unwrap();
+    let buffer = sample_buffer();
+    assert_eq!(Sample::BUFFER_SIZE, buffer.len());
+    assert!(spec.interpret_enum(&buffer).is_ok());
+}
+
+#[test]
+fn derive_undersized_buffer_err() {
+    let buffer = sample_buffer();
+    let result = Sample::from_buffer(&buffer[..buffer.len() - 1]);
+    pretty_assertions::assert_eq!(
+        result,
+        Err(ElucidatorError::BufferSizing {
+            expected: Sample::BUFFER_SIZE,
+            found: buffer.len() - 1,
+        }),
+    );
+}
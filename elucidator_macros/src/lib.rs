@@ -197,6 +197,10 @@ pub fn representable_primitive_impl(item: TokenStream) -> TokenStream {
             fn is_floating(&self) -> std::primitive::bool { #is_floating }
             fn get_dtype(&self) -> Dtype { #get_dtype_return }
             fn as_buffer(&self) -> std::vec::Vec<u8> { #buffer_conversion }
+            fn write_to(&self, buf: &mut std::vec::Vec<u8>) -> std::primitive::usize {
+                buf.extend_from_slice(&self.to_le_bytes());
+                std::mem::size_of::<#last_ident>()
+            }
             #conversion_functions
             fn as_string(&self) -> std::result::Result<std::string::String, crate::ElucidatorError> {
                 crate::ElucidatorError::new_conversion(#string_repr, "string")
@@ -288,6 +292,14 @@ pub fn representable_vec_impl(item: TokenStream) -> TokenStream {
             fn is_floating(&self) -> std::primitive::bool { #is_floating }
             fn get_dtype(&self) -> Dtype { #get_dtype_return }
             fn as_buffer(&self) -> std::vec::Vec<u8> { #buffer_conversion }
+            fn write_to(&self, buf: &mut std::vec::Vec<u8>) -> std::primitive::usize {
+                let length = self.len() * std::mem::size_of::<#last_ident>();
+                buf.reserve(length);
+                for item in self {
+                    buf.extend_from_slice(&item.to_le_bytes());
+                }
+                length
+            }
             #conversion_functions
             fn as_string(&self) -> std::result::Result<std::string::String, crate::ElucidatorError> {
                 crate::ElucidatorError::new_conversion(#string_repr_arr, "string")
@@ -341,3 +353,194 @@ pub fn make_dtype_interpreter(item: TokenStream) -> TokenStream {
     }.to_token_stream();
     buffer_conversion.into()
 }
+
+/// A member of a fixed-size spec parsed at macro expansion time.
+struct ElucidateMember {
+    identifier: String,
+    dtype: String,
+    /// `Some(n)` for a fixed array member, `None` for a singleton
+    items: Option<usize>,
+}
+
+/// Width in bytes of a fixed-size dtype, or `None` if the dtype is not
+/// part of the spec grammar.
+fn elucidate_dtype_size(dtype: &str) -> Option<usize> {
+    match dtype {
+        "u8" | "i8" => Some(1),
+        "u16" | "i16" => Some(2),
+        "u32" | "i32" | "f32" => Some(4),
+        "u64" | "i64" | "f64" => Some(8),
+        _ => None,
+    }
+}
+
+fn elucidate_valid_identifier(identifier: &str) -> bool {
+    let mut chars = identifier.chars();
+    match chars.next() {
+        Some(c) if c.is_ascii_alphabetic() => {}
+        _ => return false,
+    }
+    chars.all(|c| c.is_ascii_alphanumeric() || c == '_')
+}
+
+/// Parse one `identifier: dtype` or `identifier: dtype[n]` member,
+/// panicking (a compile error at the derive site) on anything the
+/// fixed-size subset of the grammar cannot express.
+fn elucidate_parse_member(text: &str) -> ElucidateMember {
+    let (identifier, type_text) = match text.split_once(':') {
+        Some((i, t)) => (i.trim(), t.trim()),
+        None => panic!("spec member \"{text}\" is missing \":\""),
+    };
+    if !elucidate_valid_identifier(identifier) {
+        panic!("spec member identifier \"{identifier}\" is not a valid identifier");
+    }
+    let (dtype, items) = match type_text.split_once('[') {
+        Some((dtype, sizing)) => {
+            let sizing = match sizing.strip_suffix(']') {
+                Some(s) => s.trim(),
+                None => panic!("spec member \"{text}\" has an unterminated sizing"),
+            };
+            if sizing.is_empty() {
+                panic!(
+                    "spec member \"{text}\" is dynamically sized; \
+                     Elucidate only decodes fixed-size specs — use \
+                     DesignationSpecification::interpret_enum instead"
+                );
+            }
+            let n: usize = sizing
+                .parse()
+                .unwrap_or_else(|_| panic!("spec member \"{text}\" has invalid sizing \"{sizing}\""));
+            (dtype.trim(), Some(n))
+        }
+        None => (type_text, None),
+    };
+    if dtype == "string" {
+        panic!(
+            "spec member \"{text}\" is a string; Elucidate only decodes \
+             fixed-size specs — use DesignationSpecification::interpret_enum instead"
+        );
+    }
+    if elucidate_dtype_size(dtype).is_none() {
+        panic!("spec member \"{text}\" has unknown dtype \"{dtype}\"");
+    }
+    ElucidateMember {
+        identifier: identifier.to_string(),
+        dtype: dtype.to_string(),
+        items,
+    }
+}
+
+/// Derive a zero-overhead typed decoder for a fixed-size spec.
+///
+/// The annotated struct must mirror the spec given in its `#[spec("...")]`
+/// attribute: one field per member, in order, named identically, typed as
+/// the member's primitive (or `[T; N]` for a fixed array member). The spec
+/// is parsed and validated when the derive expands, so a malformed spec or
+/// a mismatched struct is a compile error, and the generated
+/// `from_buffer` is straight-line little-endian decoding with no
+/// allocation and no per-blob map construction.
+///
+/// ```ignore
+/// #[derive(Elucidate)]
+/// #[spec("foo: u8, bar: f32[3]")]
+/// struct Foo {
+///     foo: u8,
+///     bar: [f32; 3],
+/// }
+///
+/// let value = Foo::from_buffer(&buffer)?;
+/// ```
+#[proc_macro_derive(Elucidate, attributes(spec))]
+pub fn derive_elucidate(item: TokenStream) -> TokenStream {
+    let input: DeriveInput = syn::parse(item).unwrap();
+    let spec_attr = input
+        .attrs
+        .iter()
+        .find(|a| a.path().is_ident("spec"))
+        .expect("#[derive(Elucidate)] requires a #[spec(\"...\")] attribute");
+    let spec_lit: LitStr = spec_attr
+        .parse_args()
+        .expect("#[spec(...)] takes a single string literal");
+    let members: Vec<ElucidateMember> = spec_lit
+        .value()
+        .split(',')
+        .map(elucidate_parse_member)
+        .collect();
+
+    let fields = match &input.data {
+        Data::Struct(DataStruct {
+            fields: Fields::Named(named),
+            ..
+        }) => &named.named,
+        _ => panic!("#[derive(Elucidate)] requires a struct with named fields"),
+    };
+    let field_names: Vec<String> = fields
+        .iter()
+        .map(|f| f.ident.as_ref().unwrap().to_string())
+        .collect();
+    let member_names: Vec<String> = members.iter().map(|m| m.identifier.clone()).collect();
+    if field_names != member_names {
+        panic!(
+            "struct fields {field_names:?} must match spec members {member_names:?} in name and order"
+        );
+    }
+
+    let mut offset = 0usize;
+    let mut decoders = Vec::new();
+    for member in &members {
+        let identifier = syn::Ident::new(&member.identifier, proc_macro2::Span::call_site());
+        let dtype = syn::Ident::new(&member.dtype, proc_macro2::Span::call_site());
+        let width = elucidate_dtype_size(&member.dtype).unwrap();
+        let decoder = match member.items {
+            None => {
+                let start = offset;
+                let end = offset + width;
+                offset = end;
+                quote! {
+                    #identifier: <#dtype>::from_le_bytes(
+                        buffer[#start..#end].try_into().unwrap()
+                    ),
+                }
+            }
+            Some(n) => {
+                let start = offset;
+                let end = offset + width * n;
+                offset = end;
+                quote! {
+                    #identifier: {
+                        let mut arr = [0 as #dtype; #n];
+                        for (i, chunk) in buffer[#start..#end].chunks_exact(#width).enumerate() {
+                            arr[i] = <#dtype>::from_le_bytes(chunk.try_into().unwrap());
+                        }
+                        arr
+                    },
+                }
+            }
+        };
+        decoders.push(decoder);
+    }
+    let buffer_size = offset;
+    let name = &input.ident;
+
+    let gen = quote! {
+        impl #name {
+            /// Exact buffer size of the spec this type decodes.
+            pub const BUFFER_SIZE: std::primitive::usize = #buffer_size;
+            /// Decode a buffer laid out per the spec in `#[spec(...)]`.
+            pub fn from_buffer(
+                buffer: &[std::primitive::u8],
+            ) -> std::result::Result<Self, ::elucidator::error::ElucidatorError> {
+                if buffer.len() < Self::BUFFER_SIZE {
+                    return Err(::elucidator::error::ElucidatorError::BufferSizing {
+                        expected: Self::BUFFER_SIZE,
+                        found: buffer.len(),
+                    });
+                }
+                Ok(Self {
+                    #(#decoders)*
+                })
+            }
+        }
+    };
+    gen.into()
+}
@@ -16,14 +16,18 @@ use std::{
     ptr, slice,
     sync::{
         atomic::{AtomicU32, Ordering},
-        LazyLock, RwLock,
+        Arc, LazyLock, RwLock,
     },
 };
 
 type Emap = LazyLock<RwLock<HashMap<ErrorHandle, ApiError>>>;
 static ERROR_MAP: Emap = LazyLock::new(|| RwLock::new(HashMap::new()));
 
-type Smap = LazyLock<RwLock<HashMap<SessionHandle, RTreeDatabase>>>;
+/// Sessions are individually lockable: the outer map is only write-locked
+/// when a session is created, and every operation on a session takes that
+/// session's own lock, so threads working on different handles never
+/// contend.
+type Smap = LazyLock<RwLock<HashMap<SessionHandle, Arc<RwLock<RTreeDatabase>>>>>;
 static SESSION_MAP: Smap = LazyLock::new(|| RwLock::new(HashMap::new()));
 
 #[repr(C)]
@@ -141,6 +145,27 @@ fn not_found_from<T: Handle>(hdl: &T) -> ApiError {
     }
 }
 
+/// Fetch a session's shared lock, recording a handle-not-found error when
+/// the handle is unknown. The outer map is only held for the lookup.
+fn fetch_session(
+    sh: *const SessionHandle,
+    eh: *mut ErrorHandle,
+) -> Option<Arc<RwLock<RTreeDatabase>>> {
+    let hdl = unsafe { (*sh).clone() };
+    let session = SESSION_MAP.read().unwrap().get(&hdl).cloned();
+    if session.is_none() {
+        let ehdl = ErrorHandle::get_new();
+        unsafe {
+            *eh = ehdl.clone();
+        }
+        ERROR_MAP
+            .write()
+            .unwrap()
+            .insert(ehdl, not_found_from(&hdl));
+    }
+    session
+}
+
 impl_handle!(SessionHandle);
 
 #[repr(C)]
@@ -217,6 +242,108 @@ unsafe fn blobs_into_bufnode(blobs: &mut Vec<&Vec<u8>>) -> *mut BufNode {
     bf
 }
 
+/// Contiguous query results: every blob's bytes live back to back in one
+/// arena, with blob i occupying data[offsets[i]..offsets[i] + lengths[i]].
+/// Produced by a single allocation pass and memcpy fills; free with
+/// free_blobset.
+#[repr(C)]
+#[derive(Debug)]
+pub struct BlobSet {
+    /// One contiguous allocation holding every blob back to back
+    data: *mut u8,
+    /// Total bytes held in data
+    data_len: usize,
+    /// Byte offset of each blob within data
+    offsets: *mut usize,
+    /// Length in bytes of each blob
+    lengths: *mut usize,
+    /// Number of blobs
+    count: usize,
+}
+
+/// Borrowed query results: pointers directly into the session's storage
+/// with no copy at all. The pointers remain valid only until the next call
+/// that mutates or closes the session. Free the tables (not the blobs) with
+/// free_blobview.
+#[repr(C)]
+#[derive(Debug)]
+pub struct BlobView {
+    /// Pointer to each blob's first byte, borrowed from the session
+    ptrs: *mut *const u8,
+    /// Length in bytes of each blob
+    lengths: *mut usize,
+    /// Number of blobs
+    count: usize,
+}
+
+unsafe fn blobs_into_blobset(blobs: &[&Vec<u8>]) -> BlobSet {
+    let count = blobs.len();
+    let data_len: usize = blobs.iter().map(|b| b.len()).sum();
+    let data = libc::malloc(data_len.max(1)) as *mut u8;
+    let offsets = libc::malloc(mem::size_of::<usize>() * count.max(1)) as *mut usize;
+    let lengths = libc::malloc(mem::size_of::<usize>() * count.max(1)) as *mut usize;
+    let mut cursor = 0;
+    for (i, blob) in blobs.iter().enumerate() {
+        ptr::copy_nonoverlapping(blob.as_ptr(), data.add(cursor), blob.len());
+        *offsets.add(i) = cursor;
+        *lengths.add(i) = blob.len();
+        cursor += blob.len();
+    }
+    BlobSet {
+        data,
+        data_len,
+        offsets,
+        lengths,
+        count,
+    }
+}
+
+unsafe fn blobs_into_blobview(blobs: &[&Vec<u8>]) -> BlobView {
+    let count = blobs.len();
+    let ptrs = libc::malloc(mem::size_of::<*const u8>() * count.max(1)) as *mut *const u8;
+    let lengths = libc::malloc(mem::size_of::<usize>() * count.max(1)) as *mut usize;
+    for (i, blob) in blobs.iter().enumerate() {
+        *ptrs.add(i) = blob.as_ptr();
+        *lengths.add(i) = blob.len();
+    }
+    BlobView {
+        ptrs,
+        lengths,
+        count,
+    }
+}
+
+/// Free the allocations held by a BlobSet. The struct itself is caller
+/// owned and is not freed; its pointers are nulled.
+#[no_mangle]
+#[allow(clippy::not_unsafe_ptr_arg_deref)]
+pub extern "C" fn free_blobset(bs: *mut BlobSet) {
+    unsafe {
+        libc::free((*bs).data as *mut libc::c_void);
+        libc::free((*bs).offsets as *mut libc::c_void);
+        libc::free((*bs).lengths as *mut libc::c_void);
+        (*bs).data = ptr::null_mut();
+        (*bs).offsets = ptr::null_mut();
+        (*bs).lengths = ptr::null_mut();
+        (*bs).data_len = 0;
+        (*bs).count = 0;
+    }
+}
+
+/// Free the tables held by a BlobView. The blobs themselves belong to the
+/// session and are not freed.
+#[no_mangle]
+#[allow(clippy::not_unsafe_ptr_arg_deref)]
+pub extern "C" fn free_blobview(bv: *mut BlobView) {
+    unsafe {
+        libc::free((*bv).ptrs as *mut libc::c_void);
+        libc::free((*bv).lengths as *mut libc::c_void);
+        (*bv).ptrs = ptr::null_mut();
+        (*bv).lengths = ptr::null_mut();
+        (*bv).count = 0;
+    }
+}
+
 #[no_mangle]
 pub extern "C" fn free_bufnodes(bf: *mut BufNode) {
     unsafe {
@@ -254,7 +381,10 @@ pub extern "C" fn new_session(sh: *mut SessionHandle, _kind: DatabaseKind) -> El
         }
     };
     let hdl = SessionHandle::get_new();
-    SESSION_MAP.write().unwrap().insert(hdl.clone(), rdb);
+    SESSION_MAP
+        .write()
+        .unwrap()
+        .insert(hdl.clone(), Arc::new(RwLock::new(rdb)));
     unsafe {
         *sh = hdl;
     }
@@ -274,6 +404,29 @@ pub extern "C" fn get_error_string(eh: *const ErrorHandle) -> *mut c_char {
     }
 }
 
+/// Serialize the session's instrumentation report — latency histograms,
+/// query counters, and tree statistics — to a JSON string, for export to
+/// a metrics pipeline. Returns NULL when the session cannot be found. You
+/// must free the returned pointer. Only present when the crate is built
+/// with the `instrumentation` feature.
+#[cfg(feature = "instrumentation")]
+#[no_mangle]
+#[allow(clippy::not_unsafe_ptr_arg_deref)]
+pub extern "C" fn get_instrumentation_json(
+    sh: *const SessionHandle,
+    eh: *mut ErrorHandle,
+) -> *mut c_char {
+    let session = match fetch_session(sh, eh) {
+        Some(s) => s,
+        None => return ptr::null_mut::<c_char>(),
+    };
+    let session = session.read().unwrap();
+    match session.instrumentation_report() {
+        Some(report) => CString::new(report.to_json()).unwrap().into_raw(),
+        None => ptr::null_mut::<c_char>(),
+    }
+}
+
 /// Register the given name and specification to a given session handle.
 /// On failure, an error handle will be placed into the provided pointer.
 /// Runtime should be O(1) unless the insertion causes a re-hash of a
@@ -289,22 +442,11 @@ pub extern "C" fn add_spec_to_session(
 ) -> ElucidatorStatus {
     let name = String::from_utf8_lossy(unsafe { CStr::from_ptr(name) }.to_bytes());
     let spec = String::from_utf8_lossy(unsafe { CStr::from_ptr(spec) }.to_bytes());
-    let mut map = SESSION_MAP.write().unwrap();
-    let hdl = unsafe { (*sh).clone() };
-    let session = match map.get_mut(&hdl) {
+    let session = match fetch_session(sh, eh) {
         Some(ses) => ses,
-        None => {
-            let ehdl = ErrorHandle::get_new();
-            unsafe {
-                *eh = ehdl.clone();
-            }
-            ERROR_MAP
-                .write()
-                .unwrap()
-                .insert(ehdl.clone(), not_found_from(&hdl));
-            return ElucidatorStatus::err();
-        }
+        None => return ElucidatorStatus::err(),
     };
+    let mut session = session.write().unwrap();
     match &mut session.insert_spec_text(&name, &spec) {
         Ok(_) => ElucidatorStatus::ok(),
         Err(e) => {
@@ -333,22 +475,11 @@ pub extern "C" fn insert_metadata_in_session(
     eh: *mut ErrorHandle,
 ) -> ElucidatorStatus {
     let designation = String::from_utf8_lossy(unsafe { CStr::from_ptr(designation) }.to_bytes());
-    let mut map = SESSION_MAP.write().unwrap();
-    let hdl = unsafe { (*sh).clone() };
-    let session = match map.get_mut(&hdl) {
+    let session = match fetch_session(sh, eh) {
         Some(ses) => ses,
-        None => {
-            let ehdl = ErrorHandle::get_new();
-            unsafe {
-                *eh = ehdl.clone();
-            }
-            ERROR_MAP
-                .write()
-                .unwrap()
-                .insert(ehdl.clone(), not_found_from(&hdl));
-            return ElucidatorStatus::err();
-        }
+        None => return ElucidatorStatus::err(),
     };
+    let mut session = session.write().unwrap();
     let buffer = unsafe { slice::from_raw_parts(blob, n_bytes) };
     let datum = Metadata {
         xmin: bb.a.x,
@@ -378,6 +509,63 @@ pub extern "C" fn insert_metadata_in_session(
     }
 }
 
+/// Insert a batch of metadata sharing one designation. Bounding boxes,
+/// blob pointers, and blob lengths are parallel arrays of length count.
+/// One designation read and one session lock acquisition serve the whole
+/// batch, which the database commits as a single bulk insertion, so this
+/// is the preferred path for burst ingest.
+#[no_mangle]
+#[allow(clippy::not_unsafe_ptr_arg_deref)]
+pub extern "C" fn insert_n_metadata_in_session(
+    sh: *const SessionHandle,
+    bbs: *const BoundingBox,
+    designation: *const c_char,
+    blobs: *const *const u8,
+    n_bytes: *const usize,
+    count: usize,
+    eh: *mut ErrorHandle,
+) -> ElucidatorStatus {
+    let designation = String::from_utf8_lossy(unsafe { CStr::from_ptr(designation) }.to_bytes());
+    let session = match fetch_session(sh, eh) {
+        Some(ses) => ses,
+        None => return ElucidatorStatus::err(),
+    };
+    let mut session = session.write().unwrap();
+    let bbs = unsafe { slice::from_raw_parts(bbs, count) };
+    let blobs = unsafe { slice::from_raw_parts(blobs, count) };
+    let n_bytes = unsafe { slice::from_raw_parts(n_bytes, count) };
+    let data: Vec<Metadata> = bbs
+        .iter()
+        .zip(blobs.iter().zip(n_bytes))
+        .map(|(bb, (blob, n))| Metadata {
+            xmin: bb.a.x,
+            xmax: bb.b.x,
+            ymin: bb.a.y,
+            ymax: bb.b.y,
+            zmin: bb.a.z,
+            zmax: bb.b.z,
+            tmin: bb.a.t,
+            tmax: bb.b.t,
+            designation: &designation,
+            buffer: unsafe { slice::from_raw_parts(*blob, *n) },
+        })
+        .collect();
+    match session.insert_n_metadata(&data) {
+        Ok(_) => ElucidatorStatus::ok(),
+        Err(e) => {
+            let ehdl = ErrorHandle::get_new();
+            unsafe {
+                *eh = ehdl.clone();
+            }
+            ERROR_MAP
+                .write()
+                .unwrap()
+                .insert(ehdl.clone(), ApiError::Database(e.clone()));
+            ElucidatorStatus::err()
+        }
+    }
+}
+
 /// Get metadata overlapping a point
 #[no_mangle]
 #[allow(clippy::not_unsafe_ptr_arg_deref)]
@@ -390,11 +578,33 @@ pub extern "C" fn get_metadata_in_bb(
     eh: *mut ErrorHandle,
 ) -> ElucidatorStatus {
     let designation = String::from_utf8_lossy(unsafe { CStr::from_ptr(designation) }.to_bytes());
-    let mut map = SESSION_MAP.write().unwrap();
-    let hdl = unsafe { (*sh).clone() };
-    let session = match map.get_mut(&hdl) {
+    let session = match fetch_session(sh, eh) {
         Some(ses) => ses,
-        None => {
+        None => return ElucidatorStatus::err(),
+    };
+    let session = session.read().unwrap();
+    let mut r = session.get_metadata_blobs_in_bb(
+        bb.a.x,
+        bb.b.x,
+        bb.a.y,
+        bb.b.y,
+        bb.a.z,
+        bb.b.z,
+        bb.a.t,
+        bb.b.t,
+        &designation,
+        Some(epsilon),
+    );
+    match &mut r {
+        Ok(o) => {
+            let mut refs: Vec<&Vec<u8>> = o.iter().collect();
+            unsafe {
+                let bn = blobs_into_bufnode(&mut refs);
+                *results = bn;
+            }
+            ElucidatorStatus::ok()
+        }
+        Err(e) => {
             let ehdl = ErrorHandle::get_new();
             unsafe {
                 *eh = ehdl.clone();
@@ -402,11 +612,31 @@ pub extern "C" fn get_metadata_in_bb(
             ERROR_MAP
                 .write()
                 .unwrap()
-                .insert(ehdl.clone(), not_found_from(&hdl));
-            return ElucidatorStatus::err();
+                .insert(ehdl.clone(), ApiError::Database(e.clone()));
+            ElucidatorStatus::err()
         }
+    }
+}
+
+/// Get metadata blobs overlapping a bounding box as one contiguous arena
+/// with an offsets/lengths table; see BlobSet. Free with free_blobset.
+#[no_mangle]
+#[allow(clippy::not_unsafe_ptr_arg_deref)]
+pub extern "C" fn get_metadata_blobset_in_bb(
+    sh: *const SessionHandle,
+    bb: BoundingBox,
+    designation: *const c_char,
+    epsilon: f64,
+    results: *mut BlobSet,
+    eh: *mut ErrorHandle,
+) -> ElucidatorStatus {
+    let designation = String::from_utf8_lossy(unsafe { CStr::from_ptr(designation) }.to_bytes());
+    let session = match fetch_session(sh, eh) {
+        Some(ses) => ses,
+        None => return ElucidatorStatus::err(),
     };
-    let mut r = session.get_metadata_blobs_in_bb(
+    let session = session.read().unwrap();
+    let r = session.get_metadata_blobs_in_bb(
         bb.a.x,
         bb.b.x,
         bb.a.y,
@@ -418,6 +648,135 @@ pub extern "C" fn get_metadata_in_bb(
         &designation,
         Some(epsilon),
     );
+    match r {
+        Ok(o) => {
+            let refs: Vec<&Vec<u8>> = o.iter().collect();
+            unsafe {
+                *results = blobs_into_blobset(&refs);
+            }
+            ElucidatorStatus::ok()
+        }
+        Err(e) => {
+            let ehdl = ErrorHandle::get_new();
+            unsafe {
+                *eh = ehdl.clone();
+            }
+            ERROR_MAP
+                .write()
+                .unwrap()
+                .insert(ehdl.clone(), ApiError::Database(e.clone()));
+            ElucidatorStatus::err()
+        }
+    }
+}
+
+/// Run one blob query per bounding box in a single call: one designation
+/// read and one session lock acquisition serve every box. results must
+/// point at count BlobSet slots; slot i receives box i's blobs. Free each
+/// slot with free_blobset.
+#[no_mangle]
+#[allow(clippy::not_unsafe_ptr_arg_deref)]
+pub extern "C" fn get_metadata_blobsets_in_bbs(
+    sh: *const SessionHandle,
+    bbs: *const BoundingBox,
+    count: usize,
+    designation: *const c_char,
+    epsilon: f64,
+    results: *mut BlobSet,
+    eh: *mut ErrorHandle,
+) -> ElucidatorStatus {
+    let designation = String::from_utf8_lossy(unsafe { CStr::from_ptr(designation) }.to_bytes());
+    let session = match fetch_session(sh, eh) {
+        Some(ses) => ses,
+        None => return ElucidatorStatus::err(),
+    };
+    let session = session.read().unwrap();
+    let bbs = unsafe { slice::from_raw_parts(bbs, count) };
+    for (i, bb) in bbs.iter().enumerate() {
+        let blobs = session
+            .iter_metadata_blobs_in_bb(
+                bb.a.x,
+                bb.b.x,
+                bb.a.y,
+                bb.b.y,
+                bb.a.z,
+                bb.b.z,
+                bb.a.t,
+                bb.b.t,
+                &designation,
+                Some(epsilon),
+            )
+            .map(|m| m.buffer)
+            .collect::<Vec<&Vec<u8>>>();
+        unsafe {
+            *results.add(i) = blobs_into_blobset(&blobs);
+        }
+    }
+    ElucidatorStatus::ok()
+}
+
+/// Get metadata blobs overlapping a bounding box as borrowed pointers into
+/// the session's storage with no copy; see BlobView. The pointers are only
+/// valid until the next call that mutates or closes the session. Free the
+/// tables with free_blobview.
+#[no_mangle]
+#[allow(clippy::not_unsafe_ptr_arg_deref)]
+pub extern "C" fn get_metadata_blobview_in_bb(
+    sh: *const SessionHandle,
+    bb: BoundingBox,
+    designation: *const c_char,
+    epsilon: f64,
+    results: *mut BlobView,
+    eh: *mut ErrorHandle,
+) -> ElucidatorStatus {
+    let designation = String::from_utf8_lossy(unsafe { CStr::from_ptr(designation) }.to_bytes());
+    let session = match fetch_session(sh, eh) {
+        Some(ses) => ses,
+        None => return ElucidatorStatus::err(),
+    };
+    let session = session.read().unwrap();
+    let o = session
+        .iter_metadata_blobs_in_bb(
+            bb.a.x,
+            bb.b.x,
+            bb.a.y,
+            bb.b.y,
+            bb.a.z,
+            bb.b.z,
+            bb.a.t,
+            bb.b.t,
+            &designation,
+            Some(epsilon),
+        )
+        .map(|m| m.buffer)
+        .collect::<Vec<&Vec<u8>>>();
+    unsafe {
+        *results = blobs_into_blobview(&o);
+    }
+    ElucidatorStatus::ok()
+}
+
+/// Fetch the blobs of the k data nearest to a point, closest first.
+/// Results use the same BufNode linked list as get_metadata_in_bb and
+/// must be freed with free_bufnodes.
+#[no_mangle]
+#[allow(clippy::not_unsafe_ptr_arg_deref)]
+pub extern "C" fn get_nearest_metadata(
+    sh: *const SessionHandle,
+    point: Point,
+    designation: *const c_char,
+    k: usize,
+    results: *mut *mut BufNode,
+    eh: *mut ErrorHandle,
+) -> ElucidatorStatus {
+    let designation = String::from_utf8_lossy(unsafe { CStr::from_ptr(designation) }.to_bytes());
+    let session = match fetch_session(sh, eh) {
+        Some(ses) => ses,
+        None => return ElucidatorStatus::err(),
+    };
+    let session = session.read().unwrap();
+    let mut r =
+        session.get_nearest_metadata_blobs(point.x, point.y, point.z, point.t, &designation, k);
     match &mut r {
         Ok(o) => {
             unsafe {
@@ -0,0 +1,51 @@
+use clap::Parser;
+use elucidator::designation::DesignationSpecification;
+use elucidator::representable::Representable;
+use rand::random;
+use std::time::Instant;
+
+/// Time bulk array decoding for the dtypes and sizes we use most
+#[derive(Parser)]
+struct Args {
+    /// Number of array elements per blob
+    #[arg(default_value_t = 4096)]
+    size: usize,
+    /// Number of blobs to decode per dtype
+    #[arg(default_value_t = 10_000)]
+    count: usize,
+}
+
+fn bench_decode(name: &str, spec_text: &str, blob: &[u8], count: usize) {
+    let spec = DesignationSpecification::from_text(spec_text).unwrap();
+    let compiled = spec.compile();
+    let start = Instant::now();
+    for _ in 0..count {
+        let datum = compiled.interpret_enum(std::hint::black_box(blob)).unwrap();
+        std::hint::black_box(&datum);
+    }
+    let elapsed = start.elapsed();
+    let throughput = (blob.len() * count) as f64 / elapsed.as_secs_f64() / 1e6;
+    println!(
+        "{name}: decoded {count} blobs of {} bytes in {elapsed:#?} ({throughput:.1} MB/s)",
+        blob.len(),
+    );
+}
+
+fn main() {
+    let Args { size, count } = Args::parse();
+    let u32_blob = (0..size)
+        .map(|_| random::<u32>())
+        .collect::<Vec<u32>>()
+        .as_buffer();
+    bench_decode("u32", &format!("pdf: u32[{size}]"), &u32_blob, count);
+    let f32_blob = (0..size)
+        .map(|_| random::<f32>())
+        .collect::<Vec<f32>>()
+        .as_buffer();
+    bench_decode("f32", &format!("pdf: f32[{size}]"), &f32_blob, count);
+    let f64_blob = (0..size)
+        .map(|_| random::<f64>())
+        .collect::<Vec<f64>>()
+        .as_buffer();
+    bench_decode("f64", &format!("pdf: f64[{size}]"), &f64_blob, count);
+}
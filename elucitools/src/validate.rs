@@ -1,18 +1,76 @@
 use clap::Parser;
 use elucidator::designation::DesignationSpecification;
+use rayon::prelude::*;
+use std::io::Read;
+use std::time::Instant;
 
-/// Verify that a given designation string is valid
+/// Verify that designation strings are valid
 #[derive(Parser)]
 struct Args {
     /// String to validate
-    input: String,
+    input: Option<String>,
+    /// File of specs to validate, one per line; use - for stdin
+    #[arg(short, long)]
+    file: Option<String>,
+}
+
+/// Validate every non-empty line in parallel, reporting each failure with
+/// its line number plus aggregate throughput. Exits nonzero if any spec
+/// is invalid.
+fn validate_bulk(source: &str, contents: &str) {
+    let specs: Vec<(usize, &str)> = contents
+        .lines()
+        .enumerate()
+        .map(|(i, line)| (i + 1, line.trim()))
+        .filter(|(_, line)| !line.is_empty())
+        .collect();
+    let start = Instant::now();
+    let mut failures: Vec<(usize, String)> = specs
+        .par_iter()
+        .filter_map(|(line, text)| {
+            DesignationSpecification::from_text(text)
+                .err()
+                .map(|e| (*line, format!("{e}")))
+        })
+        .collect();
+    let elapsed = start.elapsed().as_secs_f64();
+    failures.sort_by_key(|(line, _)| *line);
+    for (line, error) in &failures {
+        println!("{source}:{line}: {error}");
+    }
+    println!(
+        "{} specs validated in {elapsed:.3} s ({:.0} specs/s); {} invalid",
+        specs.len(),
+        specs.len() as f64 / elapsed,
+        failures.len(),
+    );
+    if !failures.is_empty() {
+        std::process::exit(1);
+    }
 }
 
 fn main() {
     let args = Args::parse();
 
-    match DesignationSpecification::from_text(&args.input) {
-        Ok(_) => println!("All good!"),
-        Err(e) => print!("{e}"),
+    match (args.input, args.file) {
+        (Some(input), None) => match DesignationSpecification::from_text(&input) {
+            Ok(_) => println!("All good!"),
+            Err(e) => print!("{e}"),
+        },
+        (None, Some(file)) => {
+            let contents = if file == "-" {
+                let mut buf = String::new();
+                std::io::stdin().read_to_string(&mut buf).unwrap();
+                buf
+            } else {
+                std::fs::read_to_string(&file).unwrap()
+            };
+            let source = if file == "-" { "<stdin>" } else { &file };
+            validate_bulk(source, &contents);
+        }
+        _ => {
+            eprintln!("Provide exactly one of a spec string or --file");
+            std::process::exit(2);
+        }
     }
 }
@@ -1,6 +1,10 @@
+use numpy::{IntoPyArray, PyArrayMethods};
 use pyo3::{exceptions::PyValueError, prelude::*, types::PyDict};
 
-use elucidator::{error::ElucidatorError, value::DataValue};
+use elucidator::{
+    error::ElucidatorError,
+    value::{Column, ColumnValues, DataValue},
+};
 
 use elucidator_db::{
     backends::rtree::RTreeDatabase,
@@ -173,11 +177,97 @@ impl Session {
             Err(e) => Err(Into::<PyErr>::into(ApiError::from(e)))?,
         }
     }
+    /// Fetch the k data nearest to a point, closest first.
+    fn get_nearest_metadata<'py>(
+        &self,
+        py: Python<'py>,
+        designation: &str,
+        point: &Point,
+        k: usize,
+    ) -> PyResult<Vec<Bound<'py, PyDict>>> {
+        let r = self
+            .db
+            .get_nearest_metadata(point.x, point.y, point.z, point.t, designation, k);
+        match &r {
+            Ok(o) => Ok(o.iter().map(|x| value2obj(py, x).unwrap()).collect()),
+            Err(e) => Err(Into::<PyErr>::into(ApiError::from(e)))?,
+        }
+    }
+    /// Fetch query results as one NumPy array per member instead of one
+    /// dict per datum. The columns are decoded into contiguous Rust
+    /// buffers whose ownership moves into the returned arrays, so the
+    /// Python boundary cost is O(members) rather than O(data x members).
+    /// Fixed array members come back two-dimensional (rows x items).
+    fn get_metadata_arrays<'py>(
+        &self,
+        py: Python<'py>,
+        designation: &str,
+        bb: &BoundingBox,
+        eps: Option<f64>,
+    ) -> PyResult<Bound<'py, PyDict>> {
+        let columnar = self
+            .db
+            .get_columnar_metadata_in_bb(
+                bb.a.x,
+                bb.b.x,
+                bb.a.y,
+                bb.b.y,
+                bb.a.z,
+                bb.b.z,
+                bb.a.t,
+                bb.b.t,
+                designation,
+                eps,
+            )
+            .map_err(|e| Into::<PyErr>::into(ApiError::from(e)))?;
+        let rows = columnar.rows();
+        let d = PyDict::new_bound(py);
+        for (identifier, column) in columnar.into_columns() {
+            column2obj(py, &d, &identifier, column, rows)?;
+        }
+        Ok(d)
+    }
     fn print(&self) {
         println!("{self:#?}");
     }
 }
 
+/// Move one decoded column into the result dict as a NumPy array,
+/// reshaping to (rows, items_per_row) for fixed array members. String
+/// columns fall back to a list.
+fn column2obj(
+    py: Python<'_>,
+    d: &Bound<'_, PyDict>,
+    identifier: &str,
+    column: Column,
+    rows: usize,
+) -> PyResult<()> {
+    macro_rules! set_array {
+        ($values:expr) => {{
+            let arr = $values.into_pyarray_bound(py);
+            if column.items_per_row > 1 {
+                d.set_item(identifier, arr.reshape([rows, column.items_per_row])?)?;
+            } else {
+                d.set_item(identifier, arr)?;
+            }
+        }};
+    }
+    match column.values {
+        ColumnValues::Byte(v) => set_array!(v),
+        ColumnValues::UnsignedInteger16(v) => set_array!(v),
+        ColumnValues::UnsignedInteger32(v) => set_array!(v),
+        ColumnValues::UnsignedInteger64(v) => set_array!(v),
+        ColumnValues::SignedInteger8(v) => set_array!(v),
+        ColumnValues::SignedInteger16(v) => set_array!(v),
+        ColumnValues::SignedInteger32(v) => set_array!(v),
+        ColumnValues::SignedInteger64(v) => set_array!(v),
+        ColumnValues::Float32(v) => set_array!(v),
+        ColumnValues::Float64(v) => set_array!(v),
+        ColumnValues::Str(v) => d.set_item(identifier, v)?,
+    }
+    Ok(())
+}
+
 /// A Python module implemented in Rust.
 #[pymodule]
 fn pyelucidator(m: &Bound<'_, PyModule>) -> PyResult<()> {